@@ -0,0 +1,306 @@
+// Header
+#include "balancing.h"
+
+// Includes
+#include "cell_model.h"
+#include "monitor_thread.h"
+#include "peripherals/eeprom_slots.h"
+
+// C Standard Library
+#include <stddef.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The minimum time between stores of the ledger while balancing. This limits the wear of the EEPROM.
+#define LEDGER_STORE_PERIOD		TIME_S2I (300)
+
+/// @brief The number of cells each LTC discharges when balancing starts. This is the fixed count used prior to the controller,
+/// known to be safe for a cold pack.
+#define BALANCE_COUNT_INITIAL 4.0f
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+float balancingAllowances [LTC_COUNT];
+
+/// @brief The fractional part of each LTC's allowance not yet applied, see @c balancingRegulate .
+static float dutyAccumulators [LTC_COUNT];
+
+balancingLedger_t balancingLedger;
+
+/// @brief Indicates the ledger has changed since it was last stored.
+static bool ledgerDirty = false;
+
+/// @brief The time the ledger was last stored.
+static systime_t ledgerStoreTime;
+
+/// @brief The discharge time of each cell as of the last call to @c balancingConsume , in microseconds.
+static uint32_t consumedTimes [LTC_COUNT][LTC6811_CELL_COUNT];
+
+/// @brief Indicates @c consumedTimes is valid, that is @c balancingConsume has been called before.
+static bool consumedTimesValid = false;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Calculates the CRC of the ledger.
+ * @return The CRC, covering everything following the CRC itself.
+ */
+static uint32_t ledgerCrc (void)
+{
+	return eepromSlotsCrc32 ((const uint8_t*) &balancingLedger.budgets,
+		sizeof (balancingLedger_t) - offsetof (balancingLedger_t, budgets));
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void balancingReset (void)
+{
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+	{
+		balancingAllowances [ltc] = BALANCE_COUNT_INITIAL;
+		dutyAccumulators [ltc] = 0.0f;
+	}
+}
+
+void balancingRegulate (const float* dieTemperatures, float period, uint8_t* balanceCounts)
+{
+	float temperatureMax = physicalEepromMap->ltcTemperatureMax;
+	float temperatureTarget = temperatureMax - physicalEepromMap->balancingTemperatureMargin;
+
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+	{
+		// Integrate the error between the die temperature and the target. LTCs with headroom gain discharging cells, LTCs
+		// above the target lose them.
+		float error = temperatureTarget - dieTemperatures [ltc];
+		float allowance = balancingAllowances [ltc] + physicalEepromMap->balancingTemperatureGain * error * period;
+
+		// Saturate the allowance. Note the negated comparison also catches NaN.
+		if (!(allowance > 0.0f))
+			allowance = 0.0f;
+		if (allowance > LTC6811_CELL_COUNT)
+			allowance = LTC6811_CELL_COUNT;
+
+		// At the fault limit, stop discharging immediately rather than waiting on the integrator.
+		if (!(dieTemperatures [ltc] < temperatureMax))
+			allowance = 0.0f;
+
+		balancingAllowances [ltc] = allowance;
+
+		// The fractional part of the allowance is the duty cycle of one additional cell, which is dithered across cycles.
+		dutyAccumulators [ltc] += allowance;
+		uint8_t count = (uint8_t) dutyAccumulators [ltc];
+		dutyAccumulators [ltc] -= count;
+		balanceCounts [ltc] = count;
+	}
+}
+
+void balancingLedgerLoad (void)
+{
+	memcpy (&balancingLedger, &physicalEeprom.cache [BALANCING_LEDGER_ADDR], sizeof (balancingLedger_t));
+
+	// If the ledger is invalid (ex. never stored), start a new one.
+	if (balancingLedger.crc != ledgerCrc ())
+		memset (&balancingLedger, 0, sizeof (balancingLedger_t));
+
+	ledgerDirty = false;
+	ledgerStoreTime = chVTGetSystemTimeX ();
+}
+
+bool balancingLedgerStore (bool force)
+{
+	if (!ledgerDirty)
+		return true;
+
+	systime_t timeCurrent = chVTGetSystemTimeX ();
+	if (!force && chTimeDiffX (ledgerStoreTime, timeCurrent) < LEDGER_STORE_PERIOD)
+		return true;
+
+	// Note the ledger isn't part of the config, so its writes don't reconfigure the peripherals, see eepromSlotsStoring.
+	ledgerStoreTime = timeCurrent;
+	balancingLedger.crc = ledgerCrc ();
+	chMtxLock (&eepromMutex);
+	bool result = eepromSlotsWritePages (BALANCING_LEDGER_ADDR, &balancingLedger, sizeof (balancingLedger_t));
+	chMtxUnlock (&eepromMutex);
+	if (!result)
+		return false;
+
+	ledgerDirty = false;
+	return true;
+}
+
+float balancingSchedule (const float cellVoltages [][LTC6811_CELL_COUNT], float minVoltage)
+{
+	// The balancing threshold, as the charge between the minimum cell and a cell the threshold above it.
+	float minStateOfCharge = cellModelStateOfCharge (minVoltage);
+	float capacity = cellModelCapacity ();
+	float threshold = (cellModelStateOfCharge (minVoltage + physicalEepromMap->balancingThreshold) - minStateOfCharge)
+		* capacity;
+
+	// Cancel the budgets of cells that are no longer above the minimum. This prevents a bad plan (ex. one carried over from a
+	// previous session) from over-discharging a cell. Budgets within the threshold are not discharged (see balancingPlan), so
+	// they are considered spent.
+	bool budgeted = false;
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+	{
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+		{
+			float* budget = &balancingLedger.budgets [ltc][cell];
+			if (*budget > 0.0f && !(cellVoltages [ltc][cell] > minVoltage))
+			{
+				*budget = 0.0f;
+				ledgerDirty = true;
+			}
+
+			budgeted |= *budget > threshold;
+		}
+	}
+
+	// Don't re-plan until the current plan is complete.
+	if (budgeted)
+		return threshold;
+
+	// Budget the charge each cell must lose to reach the minimum cell's state of charge. Cells within the threshold of the
+	// minimum are not budgeted, so balancing stops once the pack is within the threshold rather than dithering about it. Note
+	// this also clears the spent remainders of the previous plan.
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+	{
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+		{
+			float voltage = cellVoltages [ltc][cell];
+			float budget = 0.0f;
+			if (voltage - minVoltage > physicalEepromMap->balancingThreshold)
+				budget = (cellModelStateOfCharge (voltage) - minStateOfCharge) * capacity;
+
+			if (balancingLedger.budgets [ltc][cell] != budget)
+			{
+				balancingLedger.budgets [ltc][cell] = budget;
+				ledgerDirty = true;
+			}
+		}
+	}
+
+	return threshold;
+}
+
+void balancingConsume (const uint32_t dischargeTimes [][LTC6811_CELL_COUNT], const float cellVoltages [][LTC6811_CELL_COUNT])
+{
+	// The first call only records the discharge times, as they are relative.
+	bool valid = consumedTimesValid;
+	consumedTimesValid = true;
+
+	float resistance = physicalEepromMap->balancingResistance;
+
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+	{
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+		{
+			// Time discharged since the last call, in microseconds. Note the unsigned difference handles wrap-around.
+			uint32_t time = dischargeTimes [ltc][cell] - consumedTimes [ltc][cell];
+			consumedTimes [ltc][cell] = dischargeTimes [ltc][cell];
+
+			if (!valid || time == 0 || !(resistance > 0.0f))
+				continue;
+
+			// Charge removed, in mAh. Note 1 mAh is 3.6 A*s.
+			float charge = cellVoltages [ltc][cell] / resistance * (time / 1e6f) / 3.6f;
+
+			balancingLedger.removed [ltc][cell] += charge;
+			balancingLedger.budgets [ltc][cell] -= charge;
+			if (balancingLedger.budgets [ltc][cell] < 0.0f)
+				balancingLedger.budgets [ltc][cell] = 0.0f;
+
+			ledgerDirty = true;
+		}
+	}
+}
+
+void balancingPlan (const float values [][LTC6811_CELL_COUNT], uint16_t ltcCount, const uint8_t* balanceCounts,
+	float threshold, uint16_t* dischargeMasks)
+{
+	// Find the minimum first, so the cells within the threshold of it can be skipped before they are ranked. Once a plan is
+	// underway most budgets are spent, so few cells make it past the threshold.
+	float minValue = values [0][0];
+	for (uint16_t ltc = 0; ltc < ltcCount; ++ltc)
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+			if (values [ltc][cell] < minValue)
+				minValue = values [ltc][cell];
+
+	for (uint16_t ltc = 0; ltc < ltcCount; ++ltc)
+	{
+		dischargeMasks [ltc] = 0;
+
+		uint8_t balanceCount = balanceCounts [ltc];
+		if (balanceCount > LTC6811_CELL_COUNT)
+			balanceCount = LTC6811_CELL_COUNT;
+
+		if (balanceCount == 0)
+			continue;
+
+		// Find the cells exceeding the threshold. If there are no more of them than may be discharged, they don't need to be
+		// ranked.
+		uint16_t candidates = 0;
+		uint8_t candidateCount = 0;
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+		{
+			if (values [ltc][cell] - minValue > threshold)
+			{
+				candidates |= 1 << cell;
+				++candidateCount;
+			}
+		}
+
+		if (candidateCount <= balanceCount)
+		{
+			dischargeMasks [ltc] = candidates;
+			continue;
+		}
+
+		// Highest candidates of this LTC, sorted from highest to lowest.
+		float topValues [LTC6811_CELL_COUNT];
+		uint8_t topIndices [LTC6811_CELL_COUNT];
+		uint8_t topCount = 0;
+
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+		{
+			if (!((candidates >> cell) & 1))
+				continue;
+
+			float value = values [ltc][cell];
+
+			// Insert the cell into the highest cells, if it is high enough. If full, the lowest entry is replaced. Note ties
+			// keep the lower cell, as the insertion is stable.
+			uint8_t position = topCount;
+			if (topCount == balanceCount)
+			{
+				if (!(value > topValues [balanceCount - 1]))
+					continue;
+				--position;
+			}
+			else
+			{
+				++topCount;
+			}
+
+			while (position > 0 && value > topValues [position - 1])
+			{
+				topValues [position] = topValues [position - 1];
+				topIndices [position] = topIndices [position - 1];
+				--position;
+			}
+
+			topValues [position] = value;
+			topIndices [position] = cell;
+		}
+
+		for (uint8_t index = 0; index < topCount; ++index)
+			dischargeMasks [ltc] |= 1 << topIndices [index];
+	}
+}
+
+void balancingApply (const uint16_t* dischargeMasks)
+{
+	for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+			monitorSetCellDischarging (ltc, cell, (dischargeMasks [ltc] >> cell) & 1);
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef BALANCING_H
+#define BALANCING_H
+
+// Balancing Planner ----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Determines which cells to discharge during balancing. Balancing is planned in terms of charge rather than
+//   voltage: each cell's voltage is converted to a state of charge using the OCV curve, and the difference from the pack's
+//   minimum state of charge is budgeted as the charge (in mAh) the cell must lose. Cells are discharged until their budgets are
+//   spent, the charge removed being calculated from the cell voltage, the discharge resistance, and the time the cell actually
+//   discharged for (as measured by the monitor thread, excluding the suspensions for measurements). A new plan is only made
+//   once every budget is spent, so balancing doesn't re-decide every cycle or dither about the threshold.
+//
+//   The budgets, along with the total charge removed from each cell, are kept in a ledger persisted in the physical EEPROM, so
+//   a plan carries across charging sessions. The ledger is stored periodically while balancing, and when balancing stops.
+//
+//   Each cycle, the cells of each LTC with the largest remaining budgets are discharged. The pack's minimum is found first, so
+//   cells within the threshold of it are skipped before anything is ranked. If an LTC has no more remaining cells than it may
+//   discharge, they are all discharged without being ranked, otherwise only the highest are kept. The result is a bitmask of
+//   discharging cells per LTC.
+//
+//   The number of cells each LTC may discharge is regulated from its die temperature. An integral controller drives each LTC's
+//   die temperature towards a target margin below the LTC overtemperature limit, so cool LTCs discharge all of their high cells
+//   while hot LTCs back off before faulting. The controller's output (the allowance) is fractional, the fractional part being
+//   the duty cycle of one additional discharging cell.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The address of the balancing ledger in the physical EEPROM. Must be page-aligned.
+#define BALANCING_LEDGER_ADDR 0x0400
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The balancing ledger, as stored in the physical EEPROM (at @c BALANCING_LEDGER_ADDR ).
+typedef struct
+{
+	/// @brief CRC-32 of the remainder of the ledger.
+	uint32_t crc;
+	/// @brief The charge each cell has yet to lose under the current plan, in mAh.
+	float budgets [LTC_COUNT][LTC6811_CELL_COUNT];
+	/// @brief The total charge removed from each cell by balancing, in mAh.
+	float removed [LTC_COUNT][LTC6811_CELL_COUNT];
+} balancingLedger_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of cells each LTC may discharge, as regulated by @c balancingRegulate .
+extern float balancingAllowances [LTC_COUNT];
+
+/// @brief The balancing ledger. Only valid after @c balancingLedgerLoad has been called.
+extern balancingLedger_t balancingLedger;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Loads the balancing ledger from the physical EEPROM. If the stored ledger is invalid, an empty ledger is used.
+ */
+void balancingLedgerLoad (void);
+
+/**
+ * @brief Stores the balancing ledger to the physical EEPROM, if it has changed.
+ * @param force If false, the ledger is only stored if its store period has elapsed.
+ * @return True if successful (or nothing was stored), false if a write failed.
+ */
+bool balancingLedgerStore (bool force);
+
+/**
+ * @brief Plans the charge each cell must lose, if the previous plan is complete. Cells that are no longer above the minimum
+ * have their budgets cancelled. A plan is complete once no budget exceeds the balancing threshold.
+ * @param cellVoltages The voltage of each cell, indexed by LTC then by cell.
+ * @param minVoltage The minimum cell voltage of the pack.
+ * @return The balancing threshold, converted to a charge in mAh at the minimum cell voltage. This is the threshold to plan
+ * the budgets with, see @c balancingPlan .
+ */
+float balancingSchedule (const float cellVoltages [][LTC6811_CELL_COUNT], float minVoltage);
+
+/**
+ * @brief Accounts for the charge removed from each cell since the previous call, based on the time each cell discharged for.
+ * The first call only records the discharge times.
+ * @param dischargeTimes The total time each cell has discharged for, in microseconds, as published in the pack snapshot.
+ * @param cellVoltages The voltage of each cell, indexed by LTC then by cell.
+ */
+void balancingConsume (const uint32_t dischargeTimes [][LTC6811_CELL_COUNT], const float cellVoltages [][LTC6811_CELL_COUNT]);
+
+/**
+ * @brief Resets the balancing controller, returning each LTC's allowance to its initial value. Should be called whenever
+ * balancing is stopped.
+ */
+void balancingReset (void);
+
+/**
+ * @brief Updates the balancing controller from the LTCs' die temperatures. Should be called once per balancing cycle.
+ * @param dieTemperatures The die temperature of each LTC, in celsius.
+ * @param period The period of the balancing cycle, in seconds.
+ * @param balanceCounts Written to contain the number of cells each LTC may discharge this cycle.
+ */
+void balancingRegulate (const float* dieTemperatures, float period, uint8_t* balanceCounts);
+
+/**
+ * @brief Plans which cells to discharge. Of each LTC's cells, those with the highest values are discharged, if their values
+ * exceed the minimum value by more than the threshold.
+ * @param values The value of each cell to balance on (ex. the remaining budgets), indexed by LTC then by cell.
+ * @param ltcCount The number of LTCs in @c values .
+ * @param balanceCounts The maximum number of cells to discharge on each LTC, at most @c LTC6811_CELL_COUNT .
+ * @param threshold The amount a cell's value must exceed the minimum value by to be discharged.
+ * @param dischargeMasks Written to contain the bitmask of discharging cells of each LTC, bit n indicating cell n.
+ */
+void balancingPlan (const float values [][LTC6811_CELL_COUNT], uint16_t ltcCount, const uint8_t* balanceCounts,
+	float threshold, uint16_t* dischargeMasks);
+
+/**
+ * @brief Applies a balancing plan to the LTCs. Must be called with the peripheral mutex locked. Note this does not write the
+ * LTCs' configuration, the next monitor cycle does.
+ * @param dischargeMasks The bitmask of discharging cells of each LTC, as returned by @c balancingPlan .
+ */
+void balancingApply (const uint16_t* dischargeMasks);
+
+#endif // BALANCING_H
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef CAN_SIGNAL_H
+#define CAN_SIGNAL_H
+
+// CAN Signal Packing ---------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Table-driven packing of CAN signals. A message's layout is described by a constant table of signal descriptors
+//   (start bit, length, scale, offset), matching the fields of a DBC signal definition. The packing functions are inline, so
+//   when called with a constant table the compiler can fold the layout into the encoder.
+//
+//   All signals use little-endian (Intel) bit ordering, where the start bit is the position of the signal's least-significant
+//   bit within the 64-bit payload. Signals may be at most 16 bits in length.
+//
+//   Each signal carries its DBC name, so the same tables can be exported as a DBC and used to decode frames on the host.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The name of the signal, as exported to the DBC.
+	const char* name;
+	/// @brief The position of the signal's least-significant bit within the payload.
+	uint8_t startBit;
+	/// @brief The number of bits in the signal, at most 16.
+	uint8_t length;
+	/// @brief Indicates the signal is a two's complement signed integer.
+	bool isSigned;
+	/// @brief The physical value of one LSB of the signal.
+	float scale;
+	/// @brief The physical value of a raw value of 0.
+	float offset;
+} canSignal_t;
+
+/// @brief Defines an unsigned signal. Physical value = raw * scale + offset.
+#define CAN_SIGNAL_UNSIGNED(name, startBit, length, scale, offset) { (name), (startBit), (length), false, (scale), (offset) }
+
+/// @brief Defines a signed signal. Physical value = raw * scale + offset.
+#define CAN_SIGNAL_SIGNED(name, startBit, length, scale, offset) { (name), (startBit), (length), true, (scale), (offset) }
+
+/// @brief Defines a 1-bit flag signal.
+#define CAN_SIGNAL_FLAG(name, bit) { (name), (bit), 1, false, 1.0f, 0.0f }
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Converts a physical value into a signal's raw value. The value is saturated to the range of the signal.
+ * @param signal The signal to encode.
+ * @param value The physical value to encode.
+ * @return The raw value, masked to the length of the signal.
+ */
+static inline uint16_t canSignalEncode (const canSignal_t* signal, float value)
+{
+	float raw = (value - signal->offset) / signal->scale;
+
+	int32_t rawMin = signal->isSigned ? -(1 << (signal->length - 1)) : 0;
+	int32_t rawMax = signal->isSigned ? (1 << (signal->length - 1)) - 1 : (1 << signal->length) - 1;
+
+	// Note the negated comparison also saturates NaN to the minimum.
+	int32_t rawInt;
+	if (!(raw > rawMin))
+		rawInt = rawMin;
+	else if (raw > rawMax)
+		rawInt = rawMax;
+	else
+		rawInt = (int32_t) raw;
+
+	return (uint16_t) (rawInt & ((1 << signal->length) - 1));
+}
+
+/**
+ * @brief Packs a set of raw signal values into a frame's payload. The payload is expected to be zeroed beforehand.
+ * @param frame The frame to write into.
+ * @param signals The layout of the signals.
+ * @param raws The raw values of the signals, as returned by @c canSignalEncode .
+ * @param count The number of signals to pack.
+ */
+static inline void canSignalPackRaw (CANTxFrame* frame, const canSignal_t* signals, const uint16_t* raws, uint8_t count)
+{
+	uint64_t payload = frame->data64 [0];
+	for (uint8_t index = 0; index < count; ++index)
+		payload |= (uint64_t) raws [index] << signals [index].startBit;
+	frame->data64 [0] = payload;
+}
+
+/**
+ * @brief Encodes and packs a set of physical signal values into a frame's payload. The payload is expected to be zeroed
+ * beforehand.
+ * @param frame The frame to write into.
+ * @param signals The layout of the signals.
+ * @param values The physical values of the signals.
+ * @param raws Written to contain the raw value of each signal.
+ * @param count The number of signals to pack.
+ */
+static inline void canSignalPack (CANTxFrame* frame, const canSignal_t* signals, const float* values, uint16_t* raws,
+	uint8_t count)
+{
+	for (uint8_t index = 0; index < count; ++index)
+		raws [index] = canSignalEncode (&signals [index], values [index]);
+
+	canSignalPackRaw (frame, signals, raws, count);
+}
+
+/**
+ * @brief Extracts a signal's physical value from a payload. This is the inverse of @c canSignalPack , used by host-side
+ * decoders.
+ * @param signal The signal to decode.
+ * @param payload The 64-bit payload of the frame.
+ * @return The physical value of the signal.
+ */
+static inline float canSignalDecode (const canSignal_t* signal, uint64_t payload)
+{
+	int32_t raw = (int32_t) ((payload >> signal->startBit) & ((1 << signal->length) - 1));
+
+	// Sign-extend negative values.
+	if (signal->isSigned && (raw >> (signal->length - 1)) != 0)
+		raw -= 1 << signal->length;
+
+	return raw * signal->scale + signal->offset;
+}
+
+#endif // CAN_SIGNAL_H
\ No newline at end of file
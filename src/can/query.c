@@ -0,0 +1,164 @@
+// Header
+#include "query.h"
+
+// Includes
+#include "pack_snapshot.h"
+#include "can/transmit_thread.h"
+
+// Conversions ----------------------------------------------------------------------------------------------------------------
+
+// Cell Voltage Values (V), matching the LTC6811's ADC resolution.
+#define CELL_VOLTAGE_INVERSE_FACTOR		10000.0f
+
+// Temperature Values (C)
+#define TEMPERATURE_INVERSE_FACTOR		100.0f
+
+/// @brief The number of elements in a single response frame.
+#define ELEMENTS_PER_FRAME				3
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Converts a value to an unsigned word, saturating to the range of the word.
+ * @param value The value to convert, in words.
+ * @return The word. NaN is converted to 0.
+ */
+static uint16_t toWord (float value)
+{
+	if (!(value > 0.0f))
+		return 0;
+	if (value > UINT16_MAX)
+		return UINT16_MAX;
+	return (uint16_t) (value + 0.5f);
+}
+
+/**
+ * @brief Converts a value to a signed word, saturating to the range of the word.
+ * @param value The value to convert, in words.
+ * @return The word, in two's complement. NaN is converted to the minimum.
+ */
+static uint16_t toSignedWord (float value)
+{
+	if (!(value > INT16_MIN))
+		return (uint16_t) INT16_MIN;
+	if (value > INT16_MAX)
+		return INT16_MAX;
+	return (uint16_t) (int16_t) (value < 0.0f ? value - 0.5f : value + 0.5f);
+}
+
+/**
+ * @brief Gets the number of elements of a kind of data.
+ * @param kind The kind of data.
+ * @return The number of elements per LTC.
+ */
+static uint8_t elementCount (queryKind_t kind)
+{
+	switch (kind)
+	{
+	case QUERY_KIND_CELL_VOLTAGES:
+	case QUERY_KIND_CELL_FAULT_COUNTS:
+		return LTC6811_CELL_COUNT;
+	case QUERY_KIND_TEMPERATURES:
+		return LTC6811_GPIO_COUNT;
+	case QUERY_KIND_LTC_STATUS:
+		return QUERY_LTC_STATUS_COUNT;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Reads a single element from the pack snapshot.
+ * @param snapshot The snapshot to read from.
+ * @param kind The kind of data to read.
+ * @param ltcIndex The index of the LTC to read.
+ * @param elementIndex The index of the element to read.
+ * @return The element's word.
+ */
+static uint16_t readElement (const packSnapshot_t* snapshot, queryKind_t kind, uint8_t ltcIndex, uint8_t elementIndex)
+{
+	switch (kind)
+	{
+	case QUERY_KIND_CELL_VOLTAGES:
+		return toWord (snapshot->cellVoltages [ltcIndex][elementIndex] * CELL_VOLTAGE_INVERSE_FACTOR);
+	case QUERY_KIND_TEMPERATURES:
+		return toSignedWord (snapshot->temperatures [ltcIndex][elementIndex] * TEMPERATURE_INVERSE_FACTOR);
+	case QUERY_KIND_LTC_STATUS:
+		switch ((queryLtcStatus_t) elementIndex)
+		{
+		case QUERY_LTC_STATUS_DIE_TEMPERATURE:
+			return toSignedWord (snapshot->dieTemperatures [ltcIndex] * TEMPERATURE_INVERSE_FACTOR);
+		case QUERY_LTC_STATUS_STATE:
+			return snapshot->ltcStates [ltcIndex];
+		case QUERY_LTC_STATUS_UNDERVOLTAGE:
+			return snapshot->undervoltageFaults [ltcIndex];
+		case QUERY_LTC_STATUS_OVERVOLTAGE:
+			return snapshot->overvoltageFaults [ltcIndex];
+		case QUERY_LTC_STATUS_OPEN_WIRE:
+			return snapshot->openWireFaults [ltcIndex];
+		case QUERY_LTC_STATUS_DISCHARGING:
+			return snapshot->cellsDischarging [ltcIndex];
+		case QUERY_LTC_STATUS_UNDERTEMPERATURE:
+			return snapshot->undertemperatureFaults [ltcIndex];
+		case QUERY_LTC_STATUS_OVERTEMPERATURE:
+			return snapshot->overtemperatureFaults [ltcIndex];
+		default:
+			return 0;
+		}
+	case QUERY_KIND_CELL_FAULT_COUNTS:
+		return snapshot->cellFaultCounts [ltcIndex][elementIndex];
+	default:
+		return 0;
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void queryHandleCanRequest (CANRxFrame* frame)
+{
+	if (frame->DLC < 4)
+		return;
+
+	queryKind_t kind = frame->data8 [0];
+	uint8_t ltcIndex = frame->data8 [1];
+	uint8_t first = frame->data8 [2];
+	uint8_t count = frame->data8 [3];
+
+	// Validate the request. Note the LTC index must fit in 4 bits of the response.
+	uint8_t available = elementCount (kind);
+	if (ltcIndex >= LTC_COUNT || ltcIndex > 0xF || first >= available)
+		return;
+
+	if (count == 0 || count > available - first)
+		count = available - first;
+
+	// Copy the latest pack state. Static as the snapshot is too large for the RX thread's stack.
+	static packSnapshot_t snapshot;
+	packSnapshotRead (&snapshot);
+
+	for (uint8_t elementIndex = first; elementIndex < first + count; elementIndex += ELEMENTS_PER_FRAME)
+	{
+		uint8_t frameCount = first + count - elementIndex;
+		if (frameCount > ELEMENTS_PER_FRAME)
+			frameCount = ELEMENTS_PER_FRAME;
+
+		CANTxFrame response =
+		{
+			.DLC	= 2 + frameCount * 2,
+			.IDE	= CAN_IDE_STD,
+			.SID	= QUERY_RESPONSE_MESSAGE_ID,
+			.data8	=
+			{
+				ltcIndex | (kind << 4),
+				elementIndex
+			}
+		};
+
+		for (uint8_t offset = 0; offset < frameCount; ++offset)
+			response.data16 [offset + 1] = readElement (&snapshot, kind, ltcIndex, elementIndex + offset);
+
+		// Stop early if the queue is full, the tool must re-request regardless.
+		if (!transmitThreadEnqueue (&response, TRANSMIT_PRIORITY_NORMAL, false))
+			return;
+	}
+}
\ No newline at end of file
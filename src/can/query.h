@@ -0,0 +1,81 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+// BMS CAN Data Query ---------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Request / response service for reading full-resolution pack data over CAN. Rather than raising the resolution
+//   of the broadcast messages, a tool requests a range of values from a single LTC and the BMS responds with a few frames.
+//
+//   Request (QUERY_REQUEST_MESSAGE_ID, DLC 4):
+//     Byte 0: The kind of data to read, see @c queryKind_t .
+//     Byte 1: The index of the LTC to read.
+//     Byte 2: The index of the first element to read.
+//     Byte 3: The number of elements to read, 0 to read all remaining elements.
+//
+//   Response (QUERY_RESPONSE_MESSAGE_ID, DLC 4 to 8), 3 elements per frame:
+//     Byte 0: Bits 0-3 are the LTC index, bits 4-7 are the kind of data.
+//     Byte 1: The index of the first element in this frame.
+//     Bytes 2-7: Up to 3 16-bit little-endian elements.
+//
+//   Invalid requests (unknown kind, or LTC / element out of range) are ignored. Responses are read from the pack snapshot, so
+//   all frames of a response are from the same sample. Responses are queued at normal priority, so may be dropped if the bus is
+//   saturated, in which case the tool should re-request.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define QUERY_REQUEST_MESSAGE_ID	0x756
+#define QUERY_RESPONSE_MESSAGE_ID	0x757
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	/// @brief Cell voltages, as 16-bit LTC codes (100 uV per LSB). Indexed by cell.
+	QUERY_KIND_CELL_VOLTAGES		= 0,
+	/// @brief Thermistor temperatures, as signed 0.01 C per LSB. Indexed by GPIO.
+	QUERY_KIND_TEMPERATURES			= 1,
+	/// @brief LTC status, see @c queryLtcStatus_t .
+	QUERY_KIND_LTC_STATUS			= 2,
+	/// @brief The number of samples each cell has been reported undervoltage or overvoltage in since boot. Indexed by cell.
+	QUERY_KIND_CELL_FAULT_COUNTS	= 3,
+	QUERY_KIND_COUNT				= 4
+} queryKind_t;
+
+typedef enum
+{
+	/// @brief The LTC's die temperature, as signed 0.01 C per LSB.
+	QUERY_LTC_STATUS_DIE_TEMPERATURE	= 0,
+	/// @brief The LTC's state, see @c ltc6811State_t .
+	QUERY_LTC_STATUS_STATE				= 1,
+	/// @brief Bitmask of the LTC's undervoltage cells.
+	QUERY_LTC_STATUS_UNDERVOLTAGE		= 2,
+	/// @brief Bitmask of the LTC's overvoltage cells.
+	QUERY_LTC_STATUS_OVERVOLTAGE		= 3,
+	/// @brief Bitmask of the LTC's open sense-lines.
+	QUERY_LTC_STATUS_OPEN_WIRE			= 4,
+	/// @brief Bitmask of the LTC's discharging cells.
+	QUERY_LTC_STATUS_DISCHARGING		= 5,
+	/// @brief Bitmask of the LTC's undertemperature thermistors.
+	QUERY_LTC_STATUS_UNDERTEMPERATURE	= 6,
+	/// @brief Bitmask of the LTC's overtemperature thermistors.
+	QUERY_LTC_STATUS_OVERTEMPERATURE	= 7,
+	QUERY_LTC_STATUS_COUNT				= 8
+} queryLtcStatus_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Handles a data query request, queueing the response frames for transmission.
+ * @param frame The request frame to handle.
+ */
+void queryHandleCanRequest (CANRxFrame* frame);
+
+#endif // QUERY_H
\ No newline at end of file
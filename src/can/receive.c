@@ -5,21 +5,121 @@
 #include "peripherals.h"
 #include "can/can_thread.h"
 #include "can/eeprom_can.h"
+#include "can/query.h"
+#include "can/transfer.h"
 #include "watchdog.h"
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
 #define EEPROM_COMMAND_MESSAGE_ID 0x752
 
+/// @brief The range of SIDs covered by the dispatch table. All received SIDs must be within this range.
+#define RECEIVE_SID_BASE	0x750
+#define RECEIVE_SID_COUNT	16
+
+/// @brief The number of 16-bit identifiers in a filter bank, in list mode.
+#define FILTER_BANK_SIZE	4
+
+// Handlers -------------------------------------------------------------------------------------------------------------------
+
+typedef void (receiveHandler_t) (const canThreadConfig_t* config, CANRxFrame* frame);
+
+static void handleEepromCommand (const canThreadConfig_t* config, CANRxFrame* frame)
+{
+	eepromHandleCanCommand (frame, config->driver, (eeprom_t*) &virtualEeprom);
+}
+
+static void handleQueryRequest (const canThreadConfig_t* config, CANRxFrame* frame)
+{
+	(void) config;
+	queryHandleCanRequest (frame);
+}
+
+static void handleTransferFrame (const canThreadConfig_t* config, CANRxFrame* frame)
+{
+	(void) config;
+	transferHandleCanFrame (frame);
+}
+
+/// @brief The SIDs the BMS receives. The acceptance filters are programmed from this list.
+static const uint16_t RECEIVE_SIDS [] =
+{
+	EEPROM_COMMAND_MESSAGE_ID,
+	QUERY_REQUEST_MESSAGE_ID,
+	TRANSFER_REQUEST_MESSAGE_ID
+};
+
+#define RECEIVE_SID_LIST_COUNT (sizeof (RECEIVE_SIDS) / sizeof (RECEIVE_SIDS [0]))
+
+/// @brief The handler of each SID, indexed by SID - @c RECEIVE_SID_BASE .
+static receiveHandler_t* const RECEIVE_HANDLERS [RECEIVE_SID_COUNT] =
+{
+	[EEPROM_COMMAND_MESSAGE_ID - RECEIVE_SID_BASE]		= &handleEepromCommand,
+	[QUERY_REQUEST_MESSAGE_ID - RECEIVE_SID_BASE]		= &handleQueryRequest,
+	[TRANSFER_REQUEST_MESSAGE_ID - RECEIVE_SID_BASE]	= &handleTransferFrame
+};
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
+void receiveSetFilters (bool acceptExtended)
+{
+	static CANFilter filters [(RECEIVE_SID_LIST_COUNT + FILTER_BANK_SIZE - 1) / FILTER_BANK_SIZE + 1];
+	uint32_t filterCount = 0;
+
+	// Standard IDs, 4 per bank in 16-bit list mode. Unused entries of the last bank repeat the last SID.
+	for (uint16_t index = 0; index < RECEIVE_SID_LIST_COUNT; index += FILTER_BANK_SIZE)
+	{
+		uint16_t ids [FILTER_BANK_SIZE];
+		for (uint16_t offset = 0; offset < FILTER_BANK_SIZE; ++offset)
+		{
+			uint16_t sidIndex = index + offset < RECEIVE_SID_LIST_COUNT ? index + offset : RECEIVE_SID_LIST_COUNT - 1;
+
+			// 16-bit filter format: STID [15:5], RTR [4], IDE [3], EXID [2:0].
+			ids [offset] = RECEIVE_SIDS [sidIndex] << 5;
+		}
+
+		filters [filterCount] = (CANFilter)
+		{
+			.filter		= filterCount,
+			.mode		= 1,	// List mode.
+			.scale		= 0,	// 16-bit scale.
+			.assignment	= 0,	// FIFO 0.
+			.register1	= ids [0] | ((uint32_t) ids [1] << 16),
+			.register2	= ids [2] | ((uint32_t) ids [3] << 16)
+		};
+		++filterCount;
+	}
+
+	if (acceptExtended)
+	{
+		// 32-bit filter format: STID [31:21], EXID [20:3], IDE [2], RTR [1]. Only the IDE bit is compared.
+		filters [filterCount] = (CANFilter)
+		{
+			.filter		= filterCount,
+			.mode		= 0,	// Mask mode.
+			.scale		= 1,	// 32-bit scale.
+			.assignment	= 0,	// FIFO 0.
+			.register1	= 1 << 2,
+			.register2	= 1 << 2
+		};
+		++filterCount;
+	}
+
+	// All filter banks are assigned to CAN 1.
+	canSTM32SetFilters (&CAND1, STM32_CAN_MAX_FILTERS, filterCount, filters);
+}
+
 int8_t receiveBmsMessage (void* arg, CANRxFrame* frame)
 {
 	// First argument is config
 	const canThreadConfig_t* config = (canThreadConfig_t*) arg;
 
-	if (frame->SID == EEPROM_COMMAND_MESSAGE_ID)
-		eepromHandleCanCommand (frame, config->driver, (eeprom_t*) &virtualEeprom);
+	if (frame->IDE != CAN_IDE_STD || frame->SID < RECEIVE_SID_BASE || frame->SID >= RECEIVE_SID_BASE + RECEIVE_SID_COUNT)
+		return 0;
+
+	receiveHandler_t* handler = RECEIVE_HANDLERS [frame->SID - RECEIVE_SID_BASE];
+	if (handler != NULL)
+		handler (config, frame);
 
 	return 0;
 }
\ No newline at end of file
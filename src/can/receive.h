@@ -6,7 +6,9 @@
 // Author: Cole Barach
 // Date Created: 2025.04.03
 //
-// Description: Function for receiving CAN messages that aren't transmitted by a specific CAN node.
+// Description: Function for receiving CAN messages that aren't transmitted by a specific CAN node. Received SIDs are declared
+//   in a single list, which is used to program the CAN peripheral's acceptance filters, and dispatched to their handler through
+//   a lookup table.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
@@ -15,6 +17,13 @@
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Programs the CAN 1 acceptance filters to only accept the SIDs handled by @c receiveBmsMessage . Must be called before
+ * the driver is started.
+ * @param acceptExtended Indicates whether all extended ID frames should also be accepted, for CAN nodes using extended IDs.
+ */
+void receiveSetFilters (bool acceptExtended);
+
 int8_t receiveBmsMessage (void* arg, CANRxFrame* frame);
 
 #endif // RECEIVE_H
\ No newline at end of file
@@ -0,0 +1,280 @@
+// Header
+#include "transfer.h"
+
+// Includes
+#include "peripherals.h"
+#include "pack_snapshot.h"
+#include "can/transmit_thread.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of the virtual EEPROM's address space.
+#define EEPROM_SOURCE_SIZE			0x2000
+
+/// @brief The maximum amount of time to wait for a flow control frame (N_Bs).
+#define FLOW_CONTROL_TIMEOUT		TIME_MS2I (1000)
+
+/// @brief The maximum amount of time to wait for room in the transmit queue before aborting the transfer.
+#define TRANSMIT_TIMEOUT			TIME_MS2I (100)
+
+/// @brief Events signalled to the thread by the receive handler.
+#define REQUEST_EVENT				EVENT_MASK (0)
+#define FLOW_CONTROL_EVENT			EVENT_MASK (1)
+
+// ISO-TP protocol control information, upper nibble of the first byte.
+#define PCI_SINGLE_FRAME			0x0
+#define PCI_FIRST_FRAME				0x1
+#define PCI_CONSECUTIVE_FRAME		0x2
+#define PCI_FLOW_CONTROL			0x3
+
+// ISO-TP flow status, lower nibble of a flow control frame's first byte.
+#define FLOW_STATUS_CONTINUE		0x0
+#define FLOW_STATUS_WAIT			0x1
+#define FLOW_STATUS_OVERFLOW		0x2
+
+/// @brief The largest payload that can be described by a standard first frame.
+#define FIRST_FRAME_LENGTH_MAX		0xFFF
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	transferSource_t source;
+	uint16_t addr;
+	uint16_t length;
+} transferRequest_t;
+
+typedef struct
+{
+	uint8_t flowStatus;
+	uint8_t blockSize;
+	uint8_t separationTime;
+} flowControl_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+static thread_t* thread = NULL;
+
+/// @brief The latest request and flow control frame, written by the receive handler. Guarded by the system lock.
+static transferRequest_t pendingRequest;
+static flowControl_t pendingFlowControl;
+
+/// @brief Copy of the pack snapshot being transferred. Copied at the start of the transfer, so the entire payload is from the
+/// same sample.
+static packSnapshot_t snapshot;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Reads a range of bytes from a transfer's source. Unmapped bytes are read as 0.
+ * @param request The transfer being read.
+ * @param offset The offset from the start of the transfer.
+ * @param data The buffer to write into.
+ * @param dataCount The number of bytes to read.
+ */
+static void readSource (const transferRequest_t* request, uint16_t offset, uint8_t* data, uint8_t dataCount)
+{
+	uint16_t addr = request->addr + offset;
+
+	if (request->source == TRANSFER_SOURCE_SNAPSHOT)
+	{
+		memcpy (data, (const uint8_t*) &snapshot + addr, dataCount);
+		return;
+	}
+
+	eeprom_t* eeprom = (eeprom_t*) &virtualEeprom;
+	if (eepromRead (eeprom, addr, data, dataCount))
+		return;
+
+	// If the range spans an unmapped address, or multiple entries of the readonly EEPROM, fall back to reading each byte.
+	for (uint8_t index = 0; index < dataCount; ++index)
+		if (!eepromRead (eeprom, addr + index, &data [index], 1))
+			data [index] = 0;
+}
+
+/**
+ * @brief Queues a frame of the active transfer for transmission.
+ * @param frame The frame to transmit.
+ * @return True if the frame was queued, false if the queue stayed full.
+ */
+static bool transmit (const CANTxFrame* frame)
+{
+	return transmitThreadEnqueueTimeout (frame, TRANSMIT_PRIORITY_LOW, TRANSMIT_TIMEOUT);
+}
+
+/**
+ * @brief Sleeps for an ISO-TP separation time.
+ * @param separationTime The separation time, as encoded in the flow control frame.
+ */
+static void separationSleep (uint8_t separationTime)
+{
+	if (separationTime == 0)
+		return;
+
+	// 0x01 to 0x7F is in milliseconds, 0xF1 to 0xF9 is in hundreds of microseconds. Reserved values use the maximum.
+	if (separationTime <= 0x7F)
+		chThdSleepMilliseconds (separationTime);
+	else if (separationTime >= 0xF1 && separationTime <= 0xF9)
+		chThdSleepMicroseconds ((separationTime - 0xF0) * 100);
+	else
+		chThdSleepMilliseconds (0x7F);
+}
+
+/**
+ * @brief Performs the latest requested transfer.
+ * @return True if the transfer was aborted by a new request, false if it completed or failed.
+ */
+static bool transferRun (void)
+{
+	chSysLock ();
+	transferRequest_t request = pendingRequest;
+	chSysUnlock ();
+
+	// Validate the request against the size of its source.
+	uint32_t sourceSize = request.source == TRANSFER_SOURCE_SNAPSHOT ? sizeof (packSnapshot_t) : EEPROM_SOURCE_SIZE;
+	if (request.source >= TRANSFER_SOURCE_COUNT || request.addr >= sourceSize)
+		return false;
+
+	uint32_t length = request.length;
+	if (length == 0 || request.addr + length > sourceSize)
+		length = sourceSize - request.addr;
+	request.length = length;
+
+	if (request.source == TRANSFER_SOURCE_SNAPSHOT)
+		packSnapshotRead (&snapshot);
+
+	// Discard any flow control frame from a previous transfer.
+	chEvtGetAndClearEvents (FLOW_CONTROL_EVENT);
+
+	// First frame
+	CANTxFrame frame =
+	{
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= TRANSFER_RESPONSE_MESSAGE_ID
+	};
+
+	uint16_t offset;
+	if (length <= FIRST_FRAME_LENGTH_MAX)
+	{
+		frame.data8 [0] = (PCI_FIRST_FRAME << 4) | (length >> 8);
+		frame.data8 [1] = length;
+		offset = 6;
+		readSource (&request, 0, &frame.data8 [2], offset);
+	}
+	else
+	{
+		// Escape sequence, the length is instead a 32-bit big-endian value.
+		frame.data8 [0] = PCI_FIRST_FRAME << 4;
+		frame.data8 [1] = 0;
+		frame.data8 [2] = length >> 24;
+		frame.data8 [3] = length >> 16;
+		frame.data8 [4] = length >> 8;
+		frame.data8 [5] = length;
+		offset = 2;
+		readSource (&request, 0, &frame.data8 [6], offset);
+	}
+
+	if (!transmit (&frame))
+		return false;
+
+	// Consecutive frames, sent in blocks.
+	uint8_t sequence = 1;
+	while (offset < length)
+	{
+		eventmask_t events = chEvtWaitAnyTimeout (REQUEST_EVENT | FLOW_CONTROL_EVENT, FLOW_CONTROL_TIMEOUT);
+		if (events & REQUEST_EVENT)
+			return true;
+		if (events == 0)
+			return false;
+
+		chSysLock ();
+		flowControl_t flowControl = pendingFlowControl;
+		chSysUnlock ();
+
+		if (flowControl.flowStatus == FLOW_STATUS_WAIT)
+			continue;
+		if (flowControl.flowStatus != FLOW_STATUS_CONTINUE)
+			return false;
+
+		// A block size of 0 means the remainder is sent without further flow control.
+		for (uint16_t blockIndex = 0; (flowControl.blockSize == 0 || blockIndex < flowControl.blockSize) && offset < length;
+			++blockIndex)
+		{
+			if (chEvtGetAndClearEvents (REQUEST_EVENT) != 0)
+				return true;
+
+			uint8_t dataCount = length - offset < 7 ? length - offset : 7;
+			frame.DLC = dataCount + 1;
+			frame.data8 [0] = (PCI_CONSECUTIVE_FRAME << 4) | sequence;
+			readSource (&request, offset, &frame.data8 [1], dataCount);
+
+			if (!transmit (&frame))
+				return false;
+
+			offset += dataCount;
+			sequence = (sequence + 1) & 0xF;
+
+			if (offset < length)
+				separationSleep (flowControl.separationTime);
+		}
+	}
+
+	return false;
+}
+
+// Threads --------------------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (transferThreadWa, 512);
+void transferThread (void* arg)
+{
+	(void) arg;
+	chRegSetThreadName ("can_transfer");
+
+	while (true)
+	{
+		chEvtWaitAny (REQUEST_EVENT);
+
+		// A new request aborts the active transfer, in which case the new transfer is started immediately.
+		while (transferRun ());
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void transferThreadStart (tprio_t priority)
+{
+	thread = chThdCreateStatic (transferThreadWa, sizeof (transferThreadWa), priority, transferThread, NULL);
+}
+
+void transferHandleCanFrame (CANRxFrame* frame)
+{
+	if (thread == NULL || frame->DLC < 1)
+		return;
+
+	uint8_t pci = frame->data8 [0] >> 4;
+
+	if (pci == PCI_SINGLE_FRAME && frame->DLC >= 6 && (frame->data8 [0] & 0xF) >= 5)
+	{
+		chSysLock ();
+		pendingRequest.source	= frame->data8 [1];
+		pendingRequest.addr		= frame->data8 [2] | (frame->data8 [3] << 8);
+		pendingRequest.length	= frame->data8 [4] | (frame->data8 [5] << 8);
+		chEvtSignalI (thread, REQUEST_EVENT);
+		chSchRescheduleS ();
+		chSysUnlock ();
+	}
+	else if (pci == PCI_FLOW_CONTROL && frame->DLC >= 3)
+	{
+		chSysLock ();
+		pendingFlowControl.flowStatus		= frame->data8 [0] & 0xF;
+		pendingFlowControl.blockSize		= frame->data8 [1];
+		pendingFlowControl.separationTime	= frame->data8 [2];
+		chEvtSignalI (thread, FLOW_CONTROL_EVENT);
+		chSchRescheduleS ();
+		chSysUnlock ();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef TRANSFER_H
+#define TRANSFER_H
+
+// BMS CAN Bulk Transfer ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Segmented transfer of large payloads over CAN, following the ISO 15765-2 (ISO-TP) framing. Used by tools to
+//   read the virtual EEPROM or the pack snapshot at close to the bus's full speed, rather than a few bytes per round trip.
+//
+//   Request (TRANSFER_REQUEST_MESSAGE_ID), sent as an ISO-TP single frame:
+//     Byte 0: 0x05, single frame PCI with a length of 5.
+//     Byte 1: The source to read, see @c transferSource_t .
+//     Bytes 2-3: The address to start reading at, little-endian.
+//     Bytes 4-5: The number of bytes to read, little-endian. 0 reads to the end of the source.
+//
+//   The BMS responds on TRANSFER_RESPONSE_MESSAGE_ID with a first frame, then waits for a flow control frame from the tool on
+//   TRANSFER_REQUEST_MESSAGE_ID. Consecutive frames are sent in blocks of the requested block size, separated by the requested
+//   separation time. Payloads larger than 4095 bytes use the 32-bit first frame length escape. Frames are not padded.
+//
+//   Only one transfer may be active at a time, a new request aborts the current transfer. A transfer is also aborted if no
+//   flow control frame is received within the timeout, or if the tool reports an overflow. Unmapped addresses within the range
+//   of a source read as 0.
+//
+//   Frames are queued for the CAN transmit thread at the lowest priority, so they are only sent once the BMS's own messages
+//   have been, and never occupy the mailboxes ahead of a queued status frame. The transfer thread blocks while the queue is
+//   full, so a block is paced by the bus's spare capacity regardless of the separation time requested. Frames that still fail
+//   to transmit are dropped, in which case the tool must re-request the transfer.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define TRANSFER_REQUEST_MESSAGE_ID		0x758
+#define TRANSFER_RESPONSE_MESSAGE_ID	0x759
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	/// @brief The BMS's virtual EEPROM, see @c VIRTUAL_EEPROM_CONFIG .
+	TRANSFER_SOURCE_EEPROM		= 0,
+	/// @brief The latest pack snapshot, see @c packSnapshot_t . The snapshot is copied when the request is received.
+	TRANSFER_SOURCE_SNAPSHOT	= 1,
+	TRANSFER_SOURCE_COUNT		= 2
+} transferSource_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the CAN transfer thread. The CAN transmit thread must already be started, see @c transmitThreadStart .
+ * @param priority The priority of the thread.
+ */
+void transferThreadStart (tprio_t priority);
+
+/**
+ * @brief Handles a frame received on @c TRANSFER_REQUEST_MESSAGE_ID , either a new request or a flow control frame for the
+ * active transfer.
+ * @param frame The frame to handle.
+ */
+void transferHandleCanFrame (CANRxFrame* frame);
+
+#endif // TRANSFER_H
\ No newline at end of file
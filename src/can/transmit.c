@@ -1,97 +1,157 @@
 // Header
 #include "transmit.h"
 
-// Conversions -----------------------------------------------------------------------------------------------------------------
+// Includes
+#include "charging.h"
+#include "profiler.h"
+#include "can/transmit_signals.h"
+#include "can/transmit_thread.h"
 
-// Cell Voltage Values (V)
-#define CELL_VOLTAGE_INVERSE_FACTOR			(1024.0f / 8.0f)
-#define CELL_VOLTAGE_TO_WORD(voltage)		(uint16_t) ((voltage) * CELL_VOLTAGE_INVERSE_FACTOR)
+// Frame Cache ----------------------------------------------------------------------------------------------------------------
 
-// Cell Temperature Values (C)
-#define CELL_TEMP_INVERSE_FACTOR			(4096.0f / 256.0f)
-#define CELL_TEMP_OFFSET					-106.0f
-#define CELL_TEMP_TO_WORD(temperature)		(uint16_t) ((temperature - CELL_TEMP_OFFSET) * CELL_TEMP_INVERSE_FACTOR)
+/// @brief The maximum interval between transmissions of a change-driven message, in milliseconds.
+#define REFRESH_PERIOD_MAX					10000
+#define REFRESH_PERIOD_DEFAULT				1000
 
-// LTC Temperature Values (C)
-#define LTC_TEMP_INVERSE_FACTOR				(1024.0f / 128.0f)
-#define LTC_TEMP_OFFSET 					-28.0f
-#define LTC_TEMP_TO_WORD(temperature)		(uint16_t) ((temperature - LTC_TEMP_OFFSET) * LTC_TEMP_INVERSE_FACTOR)
+/// @brief The maximum deadband of a change-driven message, in words.
+#define DEADBAND_WORD_MAX					64
 
-// Pack Voltage (V)
-#define PACK_VOLTAGE_INVERSE_FACTOR			(65536.0f / 819.2f)
-#define PACK_VOLTAGE_TO_WORD(voltage)		(uint16_t) ((voltage) * PACK_VOLTAGE_INVERSE_FACTOR)
+/// @brief A frame encoded from the pack snapshot, ready to be queued. Frames are only re-encoded when a new snapshot is
+/// published, so transmitting a frame is a plain copy.
+typedef struct
+{
+	/// @brief The encoded frame.
+	CANTxFrame frame;
+	/// @brief The raw values of the frame's change-driven signals.
+	uint16_t words [6];
+	/// @brief The flags of the frame. Any change to these causes a change-driven frame to be sent.
+	uint8_t flags;
+	/// @brief Indicates the frame's payload has changed since it was last queued.
+	bool dirty;
+
+	/// @brief The last queued values and flags of the frame. Note the queued frame may still be dropped by the transmit thread
+	/// if the bus is saturated, in which case the change is re-sent at the next refresh.
+	uint16_t wordsQueued [6];
+	uint8_t flagsQueued;
+	systime_t timeQueued;
+	bool queued;
+} cachedFrame_t;
+
+static cachedFrame_t statusFrame;
+static cachedFrame_t powerFrame;
+static cachedFrame_t voltageSummaryFrame;
+static cachedFrame_t temperatureSummaryFrame;
+static cachedFrame_t voltageFrames [VOLTAGE_MESSAGE_COUNT];
+static cachedFrame_t temperatureFrames [TEMPERATURE_MESSAGE_COUNT];
+static cachedFrame_t senseLineStatusFrames [SENSE_LINE_STATUS_MESSAGE_COUNT];
+static cachedFrame_t balancingFrames [BALANCING_MESSAGE_COUNT];
+static cachedFrame_t ltcTemperatureFrames [LTC_TEMPERATURE_MESSAGE_COUNT];
+
+/// @brief The sequence numbers of the snapshots the summary and bulk frames were last encoded from.
+static uint32_t summarySequence = 0;
+static uint32_t bulkSequence = 0;
+
+/**
+ * @brief Stores a newly encoded frame in the cache, marking the cached frame dirty if its payload changed.
+ * @param cache The cached frame to update.
+ * @param frame The newly encoded frame.
+ * @param words The raw values of the frame's change-driven signals.
+ * @param wordCount The number of elements in @c words .
+ * @param flags The flags of the frame.
+ */
+static void cacheStore (cachedFrame_t* cache, const CANTxFrame* frame, const uint16_t* words, uint8_t wordCount,
+	uint8_t flags)
+{
+	cache->dirty |= cache->frame.data64 [0] != frame->data64 [0];
+	cache->frame = *frame;
 
-// Pack Current (A)
-#define PACK_CURRENT_INVERSE_FACTOR			(32768.0f / 625.0f)
-#define PACK_CURRENT_TO_WORD(current)		((int16_t) ((current) * PACK_CURRENT_INVERSE_FACTOR))
+	for (uint8_t index = 0; index < wordCount; ++index)
+		cache->words [index] = words [index];
 
-// Message IDs ----------------------------------------------------------------------------------------------------------------
+	cache->flags = flags;
+}
 
-#define STATUS_MESSAGE_ID					0x727
-#define VOLTAGE_MESSAGE_BASE_ID				0x700
-#define TEMPERATURE_MESSAGE_BASE_ID			0x718
-#define SENSE_LINE_STATUS_BASE_ID			0x724
-#define POWER_MESSAGE_ID					0x728
-#define BALANCING_MESSAGE_BASE_ID			0x729
-#define LTC_TEMPERATURE_MESSAGE_BASE_ID		0x754
+/**
+ * @brief Converts a deadband from the EEPROM into a deadband in words.
+ * @param deadband The deadband to convert, in the value's units.
+ * @param factor The scale factor of the value's word.
+ * @return The deadband in words, 0 if the value is invalid.
+ */
+static uint16_t deadbandToWord (float deadband, float factor)
+{
+	// Note this also catches NaN, in case the EEPROM is uninitialized.
+	float word = deadband / factor;
+	if (!(word >= 0.0f && word <= DEADBAND_WORD_MAX))
+		return 0;
 
-// Functions ------------------------------------------------------------------------------------------------------------------
+	return (uint16_t) word;
+}
 
-void transmitBmsMessages (sysinterval_t timeout)
+/**
+ * @brief Checks whether a change-driven frame needs to be transmitted. If change-driven transmission is disabled, the frame is
+ * always transmitted.
+ * @param cache The cached frame to check.
+ * @param wordCount The number of change-driven signals in the frame.
+ * @param deadband The amount any value must change by for the frame to be sent, in words.
+ * @return True if the frame should be transmitted, false otherwise.
+ */
+static bool cacheCheck (const cachedFrame_t* cache, uint8_t wordCount, uint16_t deadband)
 {
-	// Status message
-	systime_t timeCurrent = chVTGetSystemTimeX ();
-	systime_t timeDeadline = chTimeAddX (timeCurrent, timeout);
-	transmitStatusMessage (&CAND1, timeout);
+	if (!physicalEepromMap->canDeadbandEnabled || !cache->queued || cache->flags != cache->flagsQueued)
+		return true;
 
-	// Power message
-	timeCurrent = chVTGetSystemTimeX ();
-	timeout = chTimeDiffX (timeCurrent, timeDeadline);
+	uint16_t refreshPeriod = physicalEepromMap->canRefreshPeriod;
+	if (refreshPeriod == 0 || refreshPeriod > REFRESH_PERIOD_MAX)
+		refreshPeriod = REFRESH_PERIOD_DEFAULT;
 
-	// Cell voltage messages
-	for (uint16_t index = 0; index < VOLTAGE_MESSAGE_COUNT; ++index)
-	{
-		timeCurrent = chVTGetSystemTimeX ();
-		timeout = chTimeDiffX (timeCurrent, timeDeadline);
-		transmitVoltageMessage (&CAND1, timeout, index);
-	}
+	if (chTimeDiffX (cache->timeQueued, chVTGetSystemTimeX ()) >= TIME_MS2I (refreshPeriod))
+		return true;
 
-	// Sense line temperature messages
-	for (uint16_t index = 0; index < TEMPERATURE_MESSAGE_COUNT; ++index)
-	{
-		timeCurrent = chVTGetSystemTimeX ();
-		timeout = chTimeDiffX (timeCurrent, timeDeadline);
-		transmitTemperatureMessage (&CAND1, timeout, index);
-	}
+	// If the payload hasn't changed since it was queued, no value can have moved.
+	if (!cache->dirty)
+		return false;
 
-	// Sense line status messages
-	for (uint16_t index = 0; index < SENSE_LINE_STATUS_MESSAGE_COUNT; ++index)
+	for (uint8_t index = 0; index < wordCount; ++index)
 	{
-		timeCurrent = chVTGetSystemTimeX ();
-		timeout = chTimeDiffX (timeCurrent, timeDeadline);
-		transmitSenseLineStatusMessage (&CAND1, timeout, index);
-	}
+		uint16_t delta = cache->words [index] > cache->wordsQueued [index] ?
+			cache->words [index] - cache->wordsQueued [index] : cache->wordsQueued [index] - cache->words [index];
 
-	// Cell balancing messages
-	for (uint16_t index = 0; index < BALANCING_MESSAGE_COUNT; ++index)
-	{
-		timeCurrent = chVTGetSystemTimeX ();
-		timeout = chTimeDiffX (timeCurrent, timeDeadline);
-		transmitBalancingMessage (&CAND1, timeout, index);
+		if (delta > deadband)
+			return true;
 	}
 
-	transmitPowerMessage (&CAND1, timeout);
+	return false;
+}
 
-	// LTC temperature messages
-	for (uint16_t index = 0; index < LTC_TEMPERATURE_MESSAGE_COUNT; ++index)
-	{
-		timeCurrent = chVTGetSystemTimeX ();
-		timeout = chTimeDiffX (timeCurrent, timeDeadline);
-		transmitLtcTemperatureMessage (&CAND1, timeout, index);
-	}
+/**
+ * @brief Queues a cached frame, if it needs to be transmitted.
+ * @param cache The cached frame to queue.
+ * @param priority The priority of the frame.
+ * @param wordCount The number of change-driven signals in the frame.
+ * @param deadband The amount any value must change by for the frame to be sent, in words.
+ * @return True if the frame was queued or did not need to be sent, false if the queue was full.
+ */
+static bool transmitOnChange (cachedFrame_t* cache, transmitPriority_t priority, uint8_t wordCount, uint16_t deadband)
+{
+	if (!cacheCheck (cache, wordCount, deadband))
+		return true;
+
+	if (!transmitThreadEnqueue (&cache->frame, priority, true))
+		return false;
+
+	for (uint8_t index = 0; index < wordCount; ++index)
+		cache->wordsQueued [index] = cache->words [index];
+
+	cache->flagsQueued = cache->flags;
+	cache->timeQueued = chVTGetSystemTimeX ();
+	cache->queued = true;
+	cache->dirty = false;
+	return true;
 }
 
-msg_t transmitStatusMessage (CANDriver* driver, sysinterval_t timeout)
+// Frame Encoding -------------------------------------------------------------------------------------------------------------
+
+static void encodeStatusMessage (const packSnapshot_t* snapshot)
 {
 	CANTxFrame frame =
 	{
@@ -100,125 +160,145 @@ msg_t transmitStatusMessage (CANDriver* driver, sysinterval_t timeout)
 		.SID	= STATUS_MESSAGE_ID,
 		.data8	=
 		{
-			undervoltageFault |
-			(overvoltageFault << 1) |
-			(undertemperatureFault << 2) |
-			(overtemperatureFault << 3) |
-			(senseLineFault << 4) |
-			(isospiFault << 5) |
-			(selfTestFault << 6) |
-			(charging << 7),
-			balancing |
-			(shutdownLoopClosed << 1) |
-			(prechargeComplete << 2) |
-			(shutdownLoopBlip << 3) |
-			(bmsFaultRelay << 4) |
-			(imdFaultRelay << 5) |
-			(bmsFault << 6)
+			snapshot->undervoltageFault |
+			(snapshot->overvoltageFault << 1) |
+			(snapshot->undertemperatureFault << 2) |
+			(snapshot->overtemperatureFault << 3) |
+			(snapshot->senseLineFault << 4) |
+			(snapshot->isospiFault << 5) |
+			(snapshot->selfTestFault << 6) |
+			(snapshot->charging << 7),
+			snapshot->balancing |
+			(snapshot->shutdownLoopClosed << 1) |
+			(snapshot->prechargeComplete << 2) |
+			(snapshot->shutdownLoopBlip << 3) |
+			(snapshot->bmsFaultRelay << 4) |
+			(snapshot->imdFaultRelay << 5) |
+			(snapshot->bmsFault << 6)
 		}
 	};
 
 	// IsoSPI faults
 	for (uint8_t index = 0; index < LTC_COUNT; ++index)
-		frame.data16 [1] |= (ltcs [index].state == LTC6811_STATE_FAILED || ltcs [index].state == LTC6811_STATE_PEC_ERROR) << index;
+		frame.data16 [1] |= (snapshot->ltcStates [index] == LTC6811_STATE_FAILED ||
+			snapshot->ltcStates [index] == LTC6811_STATE_PEC_ERROR) << index;
 
 	// Self test faults
 	for (uint8_t index = 0; index < LTC_COUNT; ++index)
-		frame.data16 [2] |= (ltcs [index].state == LTC6811_STATE_SELF_TEST_FAULT) << index;
+		frame.data16 [2] |= (snapshot->ltcStates [index] == LTC6811_STATE_SELF_TEST_FAULT) << index;
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	cacheStore (&statusFrame, &frame, NULL, 0, 0);
 }
 
-msg_t transmitPowerMessage (CANDriver* driver, sysinterval_t timeout)
+static void encodePowerMessage (const packSnapshot_t* snapshot)
 {
 	CANTxFrame frame =
 	{
 		.DLC	= 4,
 		.IDE	= CAN_IDE_STD,
-		.SID	= POWER_MESSAGE_ID,
-		.data16	=
-		{
-			PACK_VOLTAGE_TO_WORD (packVoltage),
-			PACK_CURRENT_TO_WORD (currentSensor.value)
-		}
+		.SID	= POWER_MESSAGE_ID
 	};
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	float values [] = { snapshot->packVoltage, snapshot->packCurrent };
+	uint16_t raws [SIGNAL_COUNT (POWER_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, POWER_MESSAGE_SIGNALS, values, raws, SIGNAL_COUNT (POWER_MESSAGE_SIGNALS));
+
+	cacheStore (&powerFrame, &frame, NULL, 0, 0);
 }
 
-msg_t transmitVoltageMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index)
+static void encodeVoltageSummaryMessage (const packSnapshot_t* snapshot)
 {
-	uint16_t ltcIndex = index / 2;
-	uint8_t voltOffset = (index % 2) * 6;
+	CANTxFrame frame =
+	{
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= VOLTAGE_SUMMARY_MESSAGE_ID
+	};
 
-	uint16_t voltages [6];
-	bool undervoltage = false;
-	bool overvoltage = false;
-	for (uint8_t voltIndex = 0; voltIndex < 6; ++voltIndex)
+	float values [] =
 	{
-		voltages [voltIndex] = CELL_VOLTAGE_TO_WORD (ltcs [ltcIndex].cellVoltages [voltOffset + voltIndex]);
-		undervoltage |= ltcs [ltcIndex].undervoltageFaults [voltOffset + voltIndex];
-		overvoltage |= ltcs [ltcIndex].overvoltageFaults [voltOffset + voltIndex];
-	}
+		snapshot->cellVoltageMin,
+		snapshot->cellVoltageMax,
+		snapshot->cellVoltageAverage,
+		snapshot->cellVoltageMinIndex,
+		snapshot->cellVoltageMaxIndex
+	};
+	uint16_t raws [SIGNAL_COUNT (VOLTAGE_SUMMARY_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, VOLTAGE_SUMMARY_MESSAGE_SIGNALS, values, raws, SIGNAL_COUNT (VOLTAGE_SUMMARY_MESSAGE_SIGNALS));
 
+	cacheStore (&voltageSummaryFrame, &frame, NULL, 0, 0);
+}
+
+static void encodeTemperatureSummaryMessage (const packSnapshot_t* snapshot)
+{
 	CANTxFrame frame =
 	{
 		.DLC	= 8,
 		.IDE	= CAN_IDE_STD,
-		.SID	= VOLTAGE_MESSAGE_BASE_ID + index,
-		.data8	=
-		{
-			voltages [0],
-			(voltages [1] << 2) | ((voltages [0] >> 8) & 0b11),
-			(voltages [2] << 4) | ((voltages [1] >> 6) & 0b1111),
-			(voltages [3] << 6) | ((voltages [2] >> 4) & 0b111111),
-			voltages [3] >> 2,
-			voltages [4],
-			(voltages [5] << 2) | ((voltages [4] >> 8) & 0b11),
-			(overvoltage << 5) | (undervoltage << 4) | ((voltages [5] >> 6) & 0b1111)
-		}
+		.SID	= TEMPERATURE_SUMMARY_MESSAGE_ID
+	};
+
+	float values [] =
+	{
+		snapshot->temperatureMin,
+		snapshot->temperatureMax,
+		snapshot->temperatureAverage,
+		snapshot->temperatureMinIndex,
+		snapshot->temperatureMaxIndex
 	};
+	uint16_t raws [SIGNAL_COUNT (TEMPERATURE_SUMMARY_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, TEMPERATURE_SUMMARY_MESSAGE_SIGNALS, values, raws,
+		SIGNAL_COUNT (TEMPERATURE_SUMMARY_MESSAGE_SIGNALS));
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	cacheStore (&temperatureSummaryFrame, &frame, NULL, 0, 0);
 }
 
-msg_t transmitTemperatureMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index)
+static void encodeVoltageMessage (const packSnapshot_t* snapshot, uint16_t index)
 {
-	uint16_t temperatures [5];
-
-	bool undertemperature = false;
-	bool overtemperature = false;
+	uint16_t ltcIndex = index / 2;
+	uint8_t voltOffset = (index % 2) * 6;
 
-	for (uint8_t tempIndex = 0; tempIndex < 5; ++tempIndex)
+	CANTxFrame frame =
 	{
-		// TODO(Barach): Temperature reading under/overflow
-		temperatures [tempIndex] = CELL_TEMP_TO_WORD (thermistors [index][tempIndex].temperature);
-		undertemperature |= thermistors [index][tempIndex].undertemperatureFault;
-		overtemperature |= thermistors [index][tempIndex].overtemperatureFault;
-	}
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= VOLTAGE_MESSAGE_BASE_ID + index
+	};
 
+	float values [SIGNAL_COUNT (VOLTAGE_MESSAGE_SIGNALS)];
+	for (uint8_t voltIndex = 0; voltIndex < 6; ++voltIndex)
+		values [voltIndex] = snapshot->cellVoltages [ltcIndex][voltOffset + voltIndex];
+	values [6] = ((snapshot->undervoltageFaults [ltcIndex] >> voltOffset) & 0b111111) != 0;
+	values [7] = ((snapshot->overvoltageFaults [ltcIndex] >> voltOffset) & 0b111111) != 0;
+
+	uint16_t raws [SIGNAL_COUNT (VOLTAGE_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, VOLTAGE_MESSAGE_SIGNALS, values, raws, SIGNAL_COUNT (VOLTAGE_MESSAGE_SIGNALS));
+
+	cacheStore (&voltageFrames [index], &frame, raws, 6, raws [6] | (raws [7] << 1));
+}
+
+static void encodeTemperatureMessage (const packSnapshot_t* snapshot, uint16_t index)
+{
 	CANTxFrame frame =
 	{
 		.DLC	= 8,
 		.IDE	= CAN_IDE_STD,
-		.SID	= TEMPERATURE_MESSAGE_BASE_ID + index,
-		.data8	=
-		{
-			temperatures [0],
-			(temperatures [1] << 4) | ((temperatures [0] >> 8) & 0b1111),
-			temperatures [1] >> 4,
-			temperatures [2],
-			(temperatures [3] << 4) | ((temperatures [2] >> 8) & 0b1111),
-			temperatures [3] >> 4,
-			temperatures [4],
-			(overtemperature << 5) | (undertemperature << 4) | ((temperatures [4] >> 8) & 0b1111)
-		}
+		.SID	= TEMPERATURE_MESSAGE_BASE_ID + index
 	};
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	float values [SIGNAL_COUNT (TEMPERATURE_MESSAGE_SIGNALS)];
+	for (uint8_t tempIndex = 0; tempIndex < 5; ++tempIndex)
+		values [tempIndex] = snapshot->temperatures [index][tempIndex];
+	values [5] = snapshot->undertemperatureFaults [index] != 0;
+	values [6] = snapshot->overtemperatureFaults [index] != 0;
+
+	uint16_t raws [SIGNAL_COUNT (TEMPERATURE_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, TEMPERATURE_MESSAGE_SIGNALS, values, raws, SIGNAL_COUNT (TEMPERATURE_MESSAGE_SIGNALS));
+
+	cacheStore (&temperatureFrames [index], &frame, raws, 5, raws [5] | (raws [6] << 1));
 }
 
-msg_t transmitSenseLineStatusMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index)
+static void encodeSenseLineStatusMessage (const packSnapshot_t* snapshot, uint16_t index)
 {
 	uint16_t ltcIndex = index * 4;
 
@@ -229,25 +309,13 @@ msg_t transmitSenseLineStatusMessage (CANDriver* driver, sysinterval_t timeout,
 		.SID	= SENSE_LINE_STATUS_BASE_ID + index,
 	};
 
-	for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT + 1; ++bit)
-		frame.data16 [0] |= ltcs [index].openWireFaults [bit] << bit;
-
-	if (LTC_COUNT > ltcIndex + 1)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT + 1; ++bit)
-			frame.data16 [1] |= ltcs [index + 1].openWireFaults [bit] << bit;
-
-	if (LTC_COUNT > ltcIndex + 2)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT + 1; ++bit)
-			frame.data16 [2] |= ltcs [index + 2].openWireFaults [bit] << bit;
-
-	if (LTC_COUNT > ltcIndex + 3)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT + 1; ++bit)
-			frame.data16 [3] |= ltcs [index + 3].openWireFaults [bit] << bit;
+	for (uint8_t ltcOffset = 0; ltcOffset < 4 && ltcIndex + ltcOffset < LTC_COUNT; ++ltcOffset)
+		frame.data16 [ltcOffset] = snapshot->openWireFaults [ltcIndex + ltcOffset];
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	cacheStore (&senseLineStatusFrames [index], &frame, frame.data16, 4, 0);
 }
 
-msg_t transmitBalancingMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index)
+static void encodeBalancingMessage (const packSnapshot_t* snapshot, uint16_t index)
 {
 	uint16_t ltcIndex = index * 4;
 
@@ -258,53 +326,217 @@ msg_t transmitBalancingMessage (CANDriver* driver, sysinterval_t timeout, uint16
 		.SID	= BALANCING_MESSAGE_BASE_ID + index,
 	};
 
-	for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT; ++bit)
-		frame.data16 [0] |= ltcs [index].cellsDischarging [bit] << bit;
+	for (uint8_t ltcOffset = 0; ltcOffset < 4 && ltcIndex + ltcOffset < LTC_COUNT; ++ltcOffset)
+		frame.data16 [ltcOffset] = snapshot->cellsDischarging [ltcIndex + ltcOffset];
 
-	if (LTC_COUNT > ltcIndex + 1)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT; ++bit)
-			frame.data16 [1] |= ltcs [index + 1].cellsDischarging [bit] << bit;
+	cacheStore (&balancingFrames [index], &frame, frame.data16, 4, 0);
+}
 
-	if (LTC_COUNT > ltcIndex + 2)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT; ++bit)
-			frame.data16 [2] |= ltcs [index + 2].cellsDischarging [bit] << bit;
+static void encodeLtcTemperatureMessage (const packSnapshot_t* snapshot, uint16_t index)
+{
+	CANTxFrame frame =
+	{
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= LTC_TEMPERATURE_MESSAGE_BASE_ID + index
+	};
+
+	// Note that unused signals are left as 0.
+	uint16_t ltcBase = index * LTC_TEMPERATURE_SIGNALS_PER_MESSAGE;
+	uint16_t raws [SIGNAL_COUNT (LTC_TEMPERATURE_MESSAGE_SIGNALS)] = {};
+	for (uint16_t ltcOffset = 0; ltcOffset < LTC_TEMPERATURE_SIGNALS_PER_MESSAGE && ltcBase + ltcOffset < LTC_COUNT; ++ltcOffset)
+		raws [ltcOffset] = canSignalEncode (&LTC_TEMPERATURE_MESSAGE_SIGNALS [ltcOffset],
+			snapshot->dieTemperatures [ltcBase + ltcOffset]);
 
-	if (LTC_COUNT > ltcIndex + 3)
-		for (uint8_t bit = 0; bit < LTC6811_CELL_COUNT; ++bit)
-			frame.data16 [3] |= ltcs [index + 3].cellsDischarging [bit] << bit;
+	canSignalPackRaw (&frame, LTC_TEMPERATURE_MESSAGE_SIGNALS, raws, SIGNAL_COUNT (LTC_TEMPERATURE_MESSAGE_SIGNALS));
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	cacheStore (&ltcTemperatureFrames [index], &frame, raws, LTC_TEMPERATURE_SIGNALS_PER_MESSAGE, 0);
 }
 
-msg_t transmitLtcTemperatureMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index)
+/**
+ * @brief Re-encodes any cached frames that are older than the latest snapshot.
+ * @param bulk Indicates whether to re-encode the bulk frames.
+ */
+static void cacheUpdate (bool bulk)
 {
-	uint16_t temperatures [6] = {};
-	uint16_t ltcBase = index * 6;
-	for (uint16_t ltcOffset = 0; ltcOffset < 6; ++ltcOffset)
+	uint32_t sequence = packSnapshotSequence ();
+	if (sequence == summarySequence && (!bulk || sequence == bulkSequence))
+		return;
+
+	// Copy the latest pack state. Static as the snapshot is too large for the caller's stack.
+	static packSnapshot_t snapshot;
+	packSnapshotRead (&snapshot);
+
+	if (snapshot.sequence != summarySequence)
 	{
-		if (ltcOffset + ltcBase >= LTC_COUNT)
-			break;
+		encodeStatusMessage (&snapshot);
+		encodePowerMessage (&snapshot);
+		encodeVoltageSummaryMessage (&snapshot);
+		encodeTemperatureSummaryMessage (&snapshot);
+		summarySequence = snapshot.sequence;
+	}
+
+	if (bulk && snapshot.sequence != bulkSequence)
+	{
+		for (uint16_t index = 0; index < VOLTAGE_MESSAGE_COUNT; ++index)
+			encodeVoltageMessage (&snapshot, index);
+
+		for (uint16_t index = 0; index < TEMPERATURE_MESSAGE_COUNT; ++index)
+			encodeTemperatureMessage (&snapshot, index);
+
+		for (uint16_t index = 0; index < SENSE_LINE_STATUS_MESSAGE_COUNT; ++index)
+			encodeSenseLineStatusMessage (&snapshot, index);
 
-		temperatures [ltcOffset] = LTC_TEMP_TO_WORD (ltcs [ltcBase + ltcOffset].dieTemperature);
+		for (uint16_t index = 0; index < BALANCING_MESSAGE_COUNT; ++index)
+			encodeBalancingMessage (&snapshot, index);
+
+		for (uint16_t index = 0; index < LTC_TEMPERATURE_MESSAGE_COUNT; ++index)
+			encodeLtcTemperatureMessage (&snapshot, index);
+
+		bulkSequence = snapshot.sequence;
 	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void transmitBmsMessages (bool bulk)
+{
+	// Nothing to transmit until the first snapshot has been published.
+	if (packSnapshotSequence () == 0)
+		return;
+
+	cacheUpdate (bulk);
+
+	// Status, power, and summary messages
+	transmitStatusMessage ();
+	transmitPowerMessage ();
+	transmitVoltageSummaryMessage ();
+	transmitTemperatureSummaryMessage ();
+
+	if (!bulk)
+		return;
+
+	// Any bulk frames still queued from the previous call are now stale.
+	transmitThreadNextGeneration ();
+
+	// Cell voltage messages
+	for (uint16_t index = 0; index < VOLTAGE_MESSAGE_COUNT; ++index)
+		transmitVoltageMessage (index);
+
+	// Sense line temperature messages
+	for (uint16_t index = 0; index < TEMPERATURE_MESSAGE_COUNT; ++index)
+		transmitTemperatureMessage (index);
+
+	// Sense line status messages
+	for (uint16_t index = 0; index < SENSE_LINE_STATUS_MESSAGE_COUNT; ++index)
+		transmitSenseLineStatusMessage (index);
+
+	// Cell balancing messages
+	for (uint16_t index = 0; index < BALANCING_MESSAGE_COUNT; ++index)
+		transmitBalancingMessage (index);
+
+	// LTC temperature messages
+	for (uint16_t index = 0; index < LTC_TEMPERATURE_MESSAGE_COUNT; ++index)
+		transmitLtcTemperatureMessage (index);
+
+	// Profiler message, one stage per call.
+	static uint16_t profilerStage = 0;
+	transmitProfilerMessage (profilerStage);
+	profilerStage = (profilerStage + 1) % PROFILER_STAGE_COUNT;
+}
+
+bool transmitStatusMessage (void)
+{
+	return transmitThreadEnqueue (&statusFrame.frame, TRANSMIT_PRIORITY_HIGH, true);
+}
+
+bool transmitPowerMessage (void)
+{
+	return transmitThreadEnqueue (&powerFrame.frame, TRANSMIT_PRIORITY_HIGH, true);
+}
+
+bool transmitVoltageSummaryMessage (void)
+{
+	return transmitThreadEnqueue (&voltageSummaryFrame.frame, TRANSMIT_PRIORITY_HIGH, true);
+}
+
+bool transmitTemperatureSummaryMessage (void)
+{
+	return transmitThreadEnqueue (&temperatureSummaryFrame.frame, TRANSMIT_PRIORITY_HIGH, true);
+}
+
+bool transmitVoltageMessage (uint16_t index)
+{
+	uint16_t deadband = deadbandToWord (physicalEepromMap->cellVoltageDeadband, CELL_VOLTAGE_FACTOR);
+	return transmitOnChange (&voltageFrames [index], TRANSMIT_PRIORITY_BULK, 6, deadband);
+}
+
+bool transmitTemperatureMessage (uint16_t index)
+{
+	uint16_t deadband = deadbandToWord (physicalEepromMap->temperatureDeadband, CELL_TEMP_FACTOR);
+	return transmitOnChange (&temperatureFrames [index], TRANSMIT_PRIORITY_BULK, 5, deadband);
+}
+
+bool transmitSenseLineStatusMessage (uint16_t index)
+{
+	return transmitOnChange (&senseLineStatusFrames [index], TRANSMIT_PRIORITY_NORMAL, 4, 0);
+}
+
+bool transmitBalancingMessage (uint16_t index)
+{
+	return transmitOnChange (&balancingFrames [index], TRANSMIT_PRIORITY_NORMAL, 4, 0);
+}
+
+bool transmitLtcTemperatureMessage (uint16_t index)
+{
+	uint16_t deadband = deadbandToWord (physicalEepromMap->temperatureDeadband, LTC_TEMP_FACTOR);
+	return transmitOnChange (&ltcTemperatureFrames [index], TRANSMIT_PRIORITY_NORMAL, LTC_TEMPERATURE_SIGNALS_PER_MESSAGE,
+		deadband);
+}
+
+bool transmitProfilerMessage (uint16_t index)
+{
+	const profilerStats_t* stats = &profilerStats [index];
+	uint32_t overrunCount = profilerOverrunCount;
 
 	CANTxFrame frame =
 	{
 		.DLC	= 8,
 		.IDE	= CAN_IDE_STD,
-		.SID	= LTC_TEMPERATURE_MESSAGE_BASE_ID + index,
+		.SID	= PROFILER_MESSAGE_ID,
 		.data8	=
 		{
-			temperatures [0],
-			(temperatures [1] << 2) | ((temperatures [0] >> 8) & 0b11),
-			(temperatures [2] << 4) | ((temperatures [1] >> 6) & 0b1111),
-			(temperatures [3] << 6) | ((temperatures [2] >> 4) & 0b111111),
-			temperatures [3] >> 2,
-			temperatures [4],
-			(temperatures [5] << 2) | ((temperatures [4] >> 8) & 0b11),
-			(temperatures [5] >> 6) & 0b1111
+			index,
+			overrunCount > UINT8_MAX ? UINT8_MAX : overrunCount
 		}
 	};
 
-	return canTransmitTimeout (driver, CAN_ANY_MAILBOX, &frame, timeout);
+	frame.data16 [1] = PROFILER_TIME_TO_WORD (stats->count != 0 ? stats->min : 0);
+	frame.data16 [2] = PROFILER_TIME_TO_WORD (stats->average);
+	frame.data16 [3] = PROFILER_TIME_TO_WORD (stats->max);
+
+	return transmitThreadEnqueue (&frame, TRANSMIT_PRIORITY_NORMAL, false);
+}
+
+bool transmitChargingMessage (void)
+{
+	CANTxFrame frame =
+	{
+		.DLC	= 8,
+		.IDE	= CAN_IDE_STD,
+		.SID	= CHARGING_MESSAGE_ID
+	};
+
+	float values [] =
+	{
+		chargingState,
+		chargingCurrentRequest,
+		chargingCurrentAllowed,
+		chargingTimeToFull,
+		chargingEnergyToFull
+	};
+	uint16_t raws [SIGNAL_COUNT (CHARGING_MESSAGE_SIGNALS)];
+	canSignalPack (&frame, CHARGING_MESSAGE_SIGNALS, values, raws, SIGNAL_COUNT (CHARGING_MESSAGE_SIGNALS));
+
+	return transmitThreadEnqueue (&frame, TRANSMIT_PRIORITY_NORMAL, false);
 }
\ No newline at end of file
@@ -6,12 +6,20 @@
 // Author: Cole Barach
 // Date Created: 2025.04.03
 //
-// Description: Functions for transmitting CAN messages that aren't directed towards a specific CAN node.
+// Description: Functions for transmitting CAN messages that aren't directed towards a specific CAN node. Messages are queued
+//   for the CAN transmit thread, see can/transmit_thread.h for details.
+//
+//   If change-driven transmission is enabled in the EEPROM, the cell voltage, temperature, sense-line, balancing, and LTC
+//   temperature messages are only sent when one of their values changes by more than the configured deadband, or when the
+//   refresh period expires. The status, power, and profiler messages are always sent.
+//
+//   Messages are encoded from the pack snapshot into a frame cache once per published snapshot, the individual transmit
+//   functions simply queue the cached frame. The bulk frames are only encoded when the bulk messages are due.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
-#include "peripherals.h"
+#include "pack_snapshot.h"
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
@@ -19,75 +27,93 @@
 #define TEMPERATURE_MESSAGE_COUNT ((TEMP_COUNT + 4) / 5)
 #define SENSE_LINE_STATUS_MESSAGE_COUNT ((WIRE_COUNT + 51) / 52)
 #define BALANCING_MESSAGE_COUNT ((CELL_COUNT + 47) / 48)
-#define LTC_TEMPERATURE_MESSAGE_COUNT ((LTC_COUNT + 7) / 8)
+#define LTC_TEMPERATURE_SIGNALS_PER_MESSAGE 6
+#define LTC_TEMPERATURE_MESSAGE_COUNT ((LTC_COUNT + LTC_TEMPERATURE_SIGNALS_PER_MESSAGE - 1) / LTC_TEMPERATURE_SIGNALS_PER_MESSAGE)
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 /**
- * @brief Transmits all of the BMS's regular CAN messages: status, power, cell voltages, temperatures, and sense-line statuses.
- * @param timeout The interval to timeout after.
+ * @brief Transmits all of the BMS's regular CAN messages: status, power, summaries, cell voltages, temperatures, and sense-line
+ * statuses.
+ * @param bulk Indicates whether to transmit the bulk messages (everything other than the status, power, and summary messages).
+ * If true, any bulk messages still queued from the previous call are dropped.
+ */
+void transmitBmsMessages (bool bulk);
+
+/**
+ * @brief Transmits the cached BMS status message.
+ * @return True if the message was queued, false otherwise.
+ */
+bool transmitStatusMessage (void);
+
+/**
+ * @brief Transmits the cached BMS power consumption message.
+ * @return True if the message was queued, false otherwise.
  */
-void transmitBmsMessages (sysinterval_t timeout);
+bool transmitPowerMessage (void);
 
 /**
- * @brief Transmits the BMS status message based on the current fault conditions.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Transmits the cached cell voltage summary message, containing the min / max / average cell voltage and the index of
+ * the min and max cells.
+ * @return True if the message was queued, false otherwise.
  */
-msg_t transmitStatusMessage (CANDriver* driver, sysinterval_t timeout);
+bool transmitVoltageSummaryMessage (void);
 
 /**
- * @brief Transmits the BMS power consumption message.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
- * @return The result of the CAN operation.
+ * @brief Transmits the cached temperature summary message, containing the min / max / average thermistor temperature and the
+ * index of the min and max thermistors.
+ * @return True if the message was queued, false otherwise.
  */
-msg_t transmitPowerMessage (CANDriver* driver, sysinterval_t timeout);
+bool transmitTemperatureSummaryMessage (void);
 
 /**
- * @brief Transmits a cell voltage message based on the current cell voltages.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
+ * @brief Transmits a cached cell voltage message.
  * @param index The index of the message to send.
- * @return The result of the CAN operation.
+ * @return True if the message was queued or did not need to be sent, false otherwise.
  */
-msg_t transmitVoltageMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index);
+bool transmitVoltageMessage (uint16_t index);
 
 /**
- * @brief Transmits a sense-line temperature message
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
+ * @brief Transmits a cached sense-line temperature message.
  * @param index The index of the message to send.
- * @return The result of the CAN operation.
+ * @return True if the message was queued or did not need to be sent, false otherwise.
  */
-msg_t transmitTemperatureMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index);
+bool transmitTemperatureMessage (uint16_t index);
 
 /**
- * @brief Transmits a sense-line status message
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
+ * @brief Transmits a cached sense-line status message.
  * @param index The index of the message to send.
- * @return The result of the CAN operation.
+ * @return True if the message was queued or did not need to be sent, false otherwise.
  */
-msg_t transmitSenseLineStatusMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index);
+bool transmitSenseLineStatusMessage (uint16_t index);
 
 /**
- * @brief Transmits a cell balancing message
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
+ * @brief Transmits a cached cell balancing message.
  * @param index The index of the message to send.
- * @return The result of the CAN operation.
+ * @return True if the message was queued or did not need to be sent, false otherwise.
  */
-msg_t transmitBalancingMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index);
+bool transmitBalancingMessage (uint16_t index);
 
 /**
- * @brief Transmits an LTC temperature message.
- * @param driver The CAN driver to use.
- * @param timeout The interval to timeout after.
+ * @brief Transmits a cached LTC temperature message.
  * @param index The index of the message to send.
- * @return The result of the CAN operation.
+ * @return True if the message was queued or did not need to be sent, false otherwise.
+ */
+bool transmitLtcTemperatureMessage (uint16_t index);
+
+/**
+ * @brief Transmits a monitor profiler message, containing the min / avg / max execution time of a single stage and the
+ * monitor thread's overrun count.
+ * @param index The index of the stage to send, see @c profilerStage_t .
+ * @return True if the message was queued, false otherwise.
+ */
+bool transmitProfilerMessage (uint16_t index);
+
+/**
+ * @brief Transmits the charging message, containing the charge controller's state, current request, and allowed current, as
+ * well as the estimated time and energy until the charge completes. Only sent while on the charger.
+ * @return True if the message was queued, false otherwise.
  */
-msg_t transmitLtcTemperatureMessage (CANDriver* driver, sysinterval_t timeout, uint16_t index);
+bool transmitChargingMessage (void);
 
 #endif // TRANSMIT_H
\ No newline at end of file
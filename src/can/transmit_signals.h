@@ -0,0 +1,166 @@
+#ifndef TRANSMIT_SIGNALS_H
+#define TRANSMIT_SIGNALS_H
+
+// BMS CAN Message Layouts ----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: The IDs, scaling, and signal layouts of the BMS's CAN messages. These tables are the single definition of the
+//   layouts: can/transmit.c packs its frames from them, and the host tools in test/ decode frames and export a DBC from them,
+//   see test/can_signal_test.c and test/dbc_export.c.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "can/can_signal.h"
+#include "can/transmit.h"
+
+// Conversions -----------------------------------------------------------------------------------------------------------------
+
+// Cell Voltage Values (V)
+#define CELL_VOLTAGE_FACTOR					(8.0f / 1024.0f)
+
+// Cell Temperature Values (C)
+#define CELL_TEMP_FACTOR					(256.0f / 4096.0f)
+#define CELL_TEMP_OFFSET					-106.0f
+
+// LTC Temperature Values (C)
+#define LTC_TEMP_FACTOR						(128.0f / 1024.0f)
+#define LTC_TEMP_OFFSET 					-28.0f
+
+// Summary Cell Voltage Values (V)
+#define SUMMARY_VOLTAGE_FACTOR				(8.0f / 65536.0f)
+
+// Pack Voltage (V)
+#define PACK_VOLTAGE_FACTOR					(819.2f / 65536.0f)
+
+// Pack Current (A)
+#define PACK_CURRENT_FACTOR					(625.0f / 32768.0f)
+
+// Charging Current Values (A)
+#define CHARGING_CURRENT_FACTOR				0.1f
+
+// Time to Full (s), saturated to the maximum word (also indicating the time is unknown).
+#define TIME_TO_FULL_FACTOR					1.0f
+
+// Energy to Full (Wh)
+#define ENERGY_TO_FULL_FACTOR				1.0f
+
+// Profiler Time Values (us), saturated to the maximum word.
+#define PROFILER_TIME_FACTOR				10
+#define PROFILER_TIME_TO_WORD(time)			(uint16_t) ((time) / PROFILER_TIME_FACTOR > UINT16_MAX ? UINT16_MAX :	\
+	(time) / PROFILER_TIME_FACTOR)
+
+// Message IDs ----------------------------------------------------------------------------------------------------------------
+
+#define STATUS_MESSAGE_ID					0x727
+#define VOLTAGE_MESSAGE_BASE_ID				0x700
+#define TEMPERATURE_MESSAGE_BASE_ID			0x718
+#define SENSE_LINE_STATUS_BASE_ID			0x724
+#define POWER_MESSAGE_ID					0x728
+#define BALANCING_MESSAGE_BASE_ID			0x729
+#define LTC_TEMPERATURE_MESSAGE_BASE_ID		0x754
+#define PROFILER_MESSAGE_ID					0x72C
+#define VOLTAGE_SUMMARY_MESSAGE_ID			0x72D
+#define TEMPERATURE_SUMMARY_MESSAGE_ID		0x72E
+#define CHARGING_MESSAGE_ID					0x72F
+
+// Message Layouts ------------------------------------------------------------------------------------------------------------
+
+/// @brief Layout of a cell voltage message: 6 cell voltages, then the undervoltage and overvoltage flags.
+static const canSignal_t VOLTAGE_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("CellVoltage0", 0, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltage1", 10, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltage2", 20, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltage3", 30, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltage4", 40, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltage5", 50, 10, CELL_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_FLAG ("UndervoltageFault", 60),
+	CAN_SIGNAL_FLAG ("OvervoltageFault", 61)
+};
+
+/// @brief Layout of a sense-line temperature message: 5 temperatures, then the undertemperature and overtemperature flags.
+static const canSignal_t TEMPERATURE_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("Temperature0", 0, 12, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("Temperature1", 12, 12, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("Temperature2", 24, 12, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("Temperature3", 36, 12, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("Temperature4", 48, 12, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_FLAG ("UndertemperatureFault", 60),
+	CAN_SIGNAL_FLAG ("OvertemperatureFault", 61)
+};
+
+/// @brief Layout of an LTC temperature message: 6 die temperatures.
+static const canSignal_t LTC_TEMPERATURE_MESSAGE_SIGNALS [LTC_TEMPERATURE_SIGNALS_PER_MESSAGE] =
+{
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature0", 0, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature1", 10, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature2", 20, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature3", 30, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature4", 40, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("LtcTemperature5", 50, 10, LTC_TEMP_FACTOR, LTC_TEMP_OFFSET)
+};
+
+/// @brief Layout of the power message: pack voltage, then pack current.
+static const canSignal_t POWER_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("PackVoltage", 0, 16, PACK_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_SIGNED ("PackCurrent", 16, 16, PACK_CURRENT_FACTOR, 0.0f)
+};
+
+/// @brief Layout of the cell voltage summary message: min, max, and average voltage, then the min and max cell indices.
+static const canSignal_t VOLTAGE_SUMMARY_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("CellVoltageMin", 0, 16, SUMMARY_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltageMax", 16, 16, SUMMARY_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltageAverage", 32, 16, SUMMARY_VOLTAGE_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltageMinIndex", 48, 8, 1.0f, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CellVoltageMaxIndex", 56, 8, 1.0f, 0.0f)
+};
+
+/// @brief Layout of the temperature summary message: min, max, and average temperature, then the min and max thermistor
+/// indices.
+static const canSignal_t TEMPERATURE_SUMMARY_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("TemperatureMin", 0, 16, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("TemperatureMax", 16, 16, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("TemperatureAverage", 32, 16, CELL_TEMP_FACTOR, CELL_TEMP_OFFSET),
+	CAN_SIGNAL_UNSIGNED ("TemperatureMinIndex", 48, 8, 1.0f, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("TemperatureMaxIndex", 56, 8, 1.0f, 0.0f)
+};
+
+/// @brief Layout of the charging message: charge controller state, current request, allowed current, then the estimated time
+/// and energy to full.
+static const canSignal_t CHARGING_MESSAGE_SIGNALS [] =
+{
+	CAN_SIGNAL_UNSIGNED ("State", 0, 8, 1.0f, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CurrentRequest", 8, 12, CHARGING_CURRENT_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("CurrentAllowed", 20, 12, CHARGING_CURRENT_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("TimeToFull", 32, 16, TIME_TO_FULL_FACTOR, 0.0f),
+	CAN_SIGNAL_UNSIGNED ("EnergyToFull", 48, 16, ENERGY_TO_FULL_FACTOR, 0.0f)
+};
+
+/// @brief Gets the number of signals in a layout.
+#define SIGNAL_COUNT(signals) (sizeof (signals) / sizeof ((signals) [0]))
+
+// Message List ---------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Lists the table-driven messages, expanding @c X (name, id, count, dlc, signals) for each. A message with a count
+ * above 1 is sent with @c count consecutive IDs, starting at @c id . The status, sense-line status, balancing, and profiler
+ * messages are bitmasks and words rather than scaled signals, so aren't listed.
+ */
+#define TRANSMIT_SIGNAL_MESSAGES(X)																						\
+	X ("BMS_CELL_VOLTAGE", VOLTAGE_MESSAGE_BASE_ID, VOLTAGE_MESSAGE_COUNT, 8, VOLTAGE_MESSAGE_SIGNALS)					\
+	X ("BMS_TEMPERATURE", TEMPERATURE_MESSAGE_BASE_ID, TEMPERATURE_MESSAGE_COUNT, 8, TEMPERATURE_MESSAGE_SIGNALS)		\
+	X ("BMS_LTC_TEMPERATURE", LTC_TEMPERATURE_MESSAGE_BASE_ID, LTC_TEMPERATURE_MESSAGE_COUNT, 8,						\
+		LTC_TEMPERATURE_MESSAGE_SIGNALS)																				\
+	X ("BMS_POWER", POWER_MESSAGE_ID, 1, 4, POWER_MESSAGE_SIGNALS)														\
+	X ("BMS_VOLTAGE_SUMMARY", VOLTAGE_SUMMARY_MESSAGE_ID, 1, 8, VOLTAGE_SUMMARY_MESSAGE_SIGNALS)						\
+	X ("BMS_TEMPERATURE_SUMMARY", TEMPERATURE_SUMMARY_MESSAGE_ID, 1, 8, TEMPERATURE_SUMMARY_MESSAGE_SIGNALS)			\
+	X ("BMS_CHARGING", CHARGING_MESSAGE_ID, 1, 8, CHARGING_MESSAGE_SIGNALS)
+
+#endif // TRANSMIT_SIGNALS_H
\ No newline at end of file
@@ -0,0 +1,236 @@
+// Header
+#include "transmit_thread.h"
+
+// Includes
+#include "profiler.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The capacity of each priority's queue.
+#define QUEUE_SIZE_HIGH		8
+#define QUEUE_SIZE_NORMAL	16
+#define QUEUE_SIZE_BULK		48
+#define QUEUE_SIZE_LOW		8
+
+/// @brief The maximum amount of time to wait for a free CAN mailbox before dropping a frame.
+#define TRANSMIT_TIMEOUT	TIME_MS2I (10)
+
+/// @brief Event signalled to the thread when a frame is queued.
+#define FRAME_QUEUED_EVENT	EVENT_MASK (0)
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	CANTxFrame frame;
+	uint32_t generation;
+	/// @brief Indicates the frame is re-sent from each pack snapshot, see @c transmitThreadEnqueue .
+	bool periodic;
+	/// @brief Indicates the frame is in its queue's mailbox, that is, it has been queued but not yet taken by the thread. Only
+	/// accessed from within a critical section.
+	bool queued;
+} queuedFrame_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+uint32_t transmitDropCount = 0;
+
+static thread_t* thread = NULL;
+static CANDriver* transmitDriver;
+static volatile uint32_t generation = 0;
+
+static objects_fifo_t queues [TRANSMIT_PRIORITY_COUNT];
+
+static queuedFrame_t queueBufferHigh [QUEUE_SIZE_HIGH];
+static queuedFrame_t queueBufferNormal [QUEUE_SIZE_NORMAL];
+static queuedFrame_t queueBufferBulk [QUEUE_SIZE_BULK];
+static queuedFrame_t queueBufferLow [QUEUE_SIZE_LOW];
+
+static msg_t queueMessagesHigh [QUEUE_SIZE_HIGH];
+static msg_t queueMessagesNormal [QUEUE_SIZE_NORMAL];
+static msg_t queueMessagesBulk [QUEUE_SIZE_BULK];
+static msg_t queueMessagesLow [QUEUE_SIZE_LOW];
+
+static queuedFrame_t* const queueBuffers [TRANSMIT_PRIORITY_COUNT] =
+{
+	queueBufferHigh,
+	queueBufferNormal,
+	queueBufferBulk,
+	queueBufferLow
+};
+
+static const uint16_t QUEUE_SIZES [TRANSMIT_PRIORITY_COUNT] =
+{
+	QUEUE_SIZE_HIGH,
+	QUEUE_SIZE_NORMAL,
+	QUEUE_SIZE_BULK,
+	QUEUE_SIZE_LOW
+};
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Takes the next frame to transmit, in order of priority.
+ * @param priority Written to contain the priority of the frame.
+ * @return The frame, or @c NULL if all queues are empty. Must be returned to the queue of the given priority.
+ */
+static queuedFrame_t* dequeue (transmitPriority_t* priority)
+{
+	chSysLock ();
+
+	for (*priority = 0; *priority < TRANSMIT_PRIORITY_COUNT; ++*priority)
+	{
+		void* frame;
+		if (chFifoReceiveObjectI (&queues [*priority], &frame) == MSG_OK)
+		{
+			((queuedFrame_t*) frame)->queued = false;
+			chSysUnlock ();
+			return frame;
+		}
+	}
+
+	chSysUnlock ();
+	return NULL;
+}
+
+/**
+ * @brief Finds a periodic frame that is still waiting in a queue. Must be called from within a critical section.
+ * @param frame The frame to find a queued copy of, matched by its ID.
+ * @param priority The priority of the queue to search.
+ * @return The queued frame, or @c NULL if there is none.
+ */
+static queuedFrame_t* findQueued (const CANTxFrame* frame, transmitPriority_t priority)
+{
+	for (uint16_t index = 0; index < QUEUE_SIZES [priority]; ++index)
+	{
+		queuedFrame_t* queuedFrame = &queueBuffers [priority][index];
+		if (!queuedFrame->queued || !queuedFrame->periodic || queuedFrame->frame.IDE != frame->IDE)
+			continue;
+
+		if (frame->IDE == CAN_IDE_STD ? queuedFrame->frame.SID == frame->SID : queuedFrame->frame.EID == frame->EID)
+			return queuedFrame;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Counts a dropped frame. Frames are dropped from multiple threads, so the count is incremented atomically.
+ */
+static void recordDrop (void)
+{
+	chSysLock ();
+	++transmitDropCount;
+	chSysUnlock ();
+}
+
+/**
+ * @brief Queues a new copy of a frame, see @c transmitThreadEnqueue .
+ * @param timeout The maximum amount of time to wait for room in the queue.
+ * @return True if the frame was queued, false if the queue remained full.
+ */
+static bool enqueue (const CANTxFrame* frame, transmitPriority_t priority, bool periodic, sysinterval_t timeout)
+{
+	queuedFrame_t* queuedFrame = chFifoTakeObjectTimeout (&queues [priority], timeout);
+	if (queuedFrame == NULL)
+	{
+		recordDrop ();
+		return false;
+	}
+
+	queuedFrame->frame = *frame;
+	queuedFrame->generation = generation;
+	queuedFrame->periodic = periodic;
+
+	chSysLock ();
+	queuedFrame->queued = true;
+	chFifoSendObjectI (&queues [priority], queuedFrame);
+	chEvtSignalI (thread, FRAME_QUEUED_EVENT);
+	chSchRescheduleS ();
+	chSysUnlock ();
+	return true;
+}
+
+// Threads --------------------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (transmitThreadWa, 512);
+void transmitThread (void* arg)
+{
+	(void) arg;
+	chRegSetThreadName ("can_tx");
+
+	while (true)
+	{
+		chEvtWaitAny (FRAME_QUEUED_EVENT);
+
+		// Transmit until all queues are empty. Note the highest priority queue is re-checked after every frame.
+		transmitPriority_t priority;
+		queuedFrame_t* frame;
+		while ((frame = dequeue (&priority)) != NULL)
+		{
+			// Drop periodic frames that have been superseded by a newer generation.
+			if (frame->periodic && priority != TRANSMIT_PRIORITY_HIGH && frame->generation != generation)
+				recordDrop ();
+			else if (canTransmitTimeout (transmitDriver, CAN_ANY_MAILBOX, &frame->frame, TRANSMIT_TIMEOUT) != MSG_OK)
+				recordDrop ();
+			else
+				profilerRecordBoot (PROFILER_BOOT_FIRST_CAN_FRAME);
+
+			chFifoReturnObject (&queues [priority], frame);
+		}
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void transmitThreadStart (tprio_t priority, CANDriver* driver)
+{
+	transmitDriver = driver;
+
+	chFifoObjectInit (&queues [TRANSMIT_PRIORITY_HIGH], sizeof (queuedFrame_t), QUEUE_SIZE_HIGH, queueBufferHigh,
+		queueMessagesHigh);
+	chFifoObjectInit (&queues [TRANSMIT_PRIORITY_NORMAL], sizeof (queuedFrame_t), QUEUE_SIZE_NORMAL, queueBufferNormal,
+		queueMessagesNormal);
+	chFifoObjectInit (&queues [TRANSMIT_PRIORITY_BULK], sizeof (queuedFrame_t), QUEUE_SIZE_BULK, queueBufferBulk,
+		queueMessagesBulk);
+	chFifoObjectInit (&queues [TRANSMIT_PRIORITY_LOW], sizeof (queuedFrame_t), QUEUE_SIZE_LOW, queueBufferLow,
+		queueMessagesLow);
+
+	thread = chThdCreateStatic (transmitThreadWa, sizeof (transmitThreadWa), priority, transmitThread, NULL);
+}
+
+bool transmitThreadEnqueue (const CANTxFrame* frame, transmitPriority_t priority, bool periodic)
+{
+	if (thread == NULL)
+		return false;
+
+	// A periodic frame that is still queued is updated in place, so the newest copy is sent in the old copy's position.
+	if (periodic)
+	{
+		chSysLock ();
+		queuedFrame_t* queuedFrame = findQueued (frame, priority);
+		if (queuedFrame != NULL)
+		{
+			queuedFrame->frame = *frame;
+			queuedFrame->generation = generation;
+			chSysUnlock ();
+			return true;
+		}
+		chSysUnlock ();
+	}
+
+	return enqueue (frame, priority, periodic, TIME_IMMEDIATE);
+}
+
+bool transmitThreadEnqueueTimeout (const CANTxFrame* frame, transmitPriority_t priority, sysinterval_t timeout)
+{
+	if (thread == NULL)
+		return false;
+
+	return enqueue (frame, priority, false, timeout);
+}
+
+void transmitThreadNextGeneration (void)
+{
+	++generation;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef TRANSMIT_THREAD_H
+#define TRANSMIT_THREAD_H
+
+// BMS CAN Transmit Thread ----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Prioritized CAN transmit queue, drained by a dedicated thread. Frames are queued by the monitor thread and
+//   transmitted in order of priority, so the monitor's timing does not depend on the bus load and safety-relevant frames are
+//   always sent first.
+//
+//   Periodic frames (those re-sent from each pack snapshot) are coalesced: if a copy of a periodic frame is still queued when
+//   it is queued again, the queued copy is updated in place rather than a second copy being queued. This way the newest data
+//   (ex. a new fault status) is never dropped in favour of stale data, even if the bus is saturated.
+//
+//   Periodic frames are also tagged with a generation when queued. Non-high priority periodic frames that are from an old
+//   generation by the time they reach the bus are dropped, as a newer snapshot has since been published. One-shot frames (ex.
+//   query responses) are never dropped for being stale. If a priority's queue is full, new frames of that priority are
+//   dropped, unless queued with a timeout, see @c transmitThreadEnqueueTimeout .
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "hal.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	TRANSMIT_PRIORITY_HIGH		= 0,	// Safety-relevant frames, never dropped for being stale.
+	TRANSMIT_PRIORITY_NORMAL	= 1,	// Status-like frames.
+	TRANSMIT_PRIORITY_BULK		= 2,	// Bulk cell data.
+	TRANSMIT_PRIORITY_LOW		= 3,	// Segmented transfers, only sent once every other queue is empty.
+	TRANSMIT_PRIORITY_COUNT		= 4
+} transmitPriority_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of frames that have been dropped, either for being stale, due to a full queue, or due to a CAN timeout.
+extern uint32_t transmitDropCount;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the CAN transmit thread.
+ * @param priority The priority of the thread.
+ * @param driver The CAN driver to transmit on.
+ */
+void transmitThreadStart (tprio_t priority, CANDriver* driver);
+
+/**
+ * @brief Queues a frame for transmission. Does not block.
+ * @param frame The frame to transmit. This is copied, so the caller may re-use it.
+ * @param priority The priority of the frame.
+ * @param periodic Indicates the frame is re-sent from each pack snapshot, so a newer copy supersedes it. False for one-shot
+ * frames, which are neither coalesced nor dropped for being stale.
+ * @return True if the frame was queued, false if the queue was full or the thread is not running.
+ */
+bool transmitThreadEnqueue (const CANTxFrame* frame, transmitPriority_t priority, bool periodic);
+
+/**
+ * @brief Queues a one-shot frame for transmission, blocking until there is room in the queue. Used by senders that must not
+ * lose frames to a full queue, such as segmented transfers, which are then paced by the rate the queue is drained at.
+ * @param frame The frame to transmit. This is copied, so the caller may re-use it.
+ * @param priority The priority of the frame.
+ * @param timeout The maximum amount of time to wait for room in the queue.
+ * @return True if the frame was queued, false if the timeout expired or the thread is not running.
+ */
+bool transmitThreadEnqueueTimeout (const CANTxFrame* frame, transmitPriority_t priority, sysinterval_t timeout);
+
+/**
+ * @brief Starts a new generation of frames. Any queued, non-high priority periodic frames of a previous generation will be
+ * dropped rather than transmitted.
+ */
+void transmitThreadNextGeneration (void);
+
+#endif // TRANSMIT_THREAD_H
\ No newline at end of file
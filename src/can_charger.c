@@ -4,6 +4,8 @@
 // Includes
 #include "can/can_thread.h"
 #include "can/receive.h"
+#include "can/transfer.h"
+#include "can/transmit_thread.h"
 
 // Threads --------------------------------------------------------------------------------------------------------------------
 
@@ -58,6 +60,9 @@ static const tcChargerConfig_t CHARGER_CONFIG =
 
 bool canChargerInit (tprio_t priority)
 {
+	// Accept the messages handled by the BMS, as well as the charger's extended ID messages.
+	receiveSetFilters (true);
+
 	// CAN 1 driver initialization
 	if (canStart (&CAND1, &CAN1_CONFIG) != MSG_OK)
 		return false;
@@ -71,5 +76,11 @@ bool canChargerInit (tprio_t priority)
 	// Create the CAN RX thread
 	canThreadStart (can1RxThreadWa, sizeof (can1RxThreadWa), priority, &CAN1_RX_THREAD_CONFIG);
 
+	// Create the CAN TX thread
+	transmitThreadStart (priority, &CAND1);
+
+	// Create the CAN transfer thread
+	transferThreadStart (priority);
+
 	return true;
 }
\ No newline at end of file
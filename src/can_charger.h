@@ -8,6 +8,10 @@
 //
 // Description: CAN interface for when the accumulator is on the charger. This bus runs at 500 kbps as opposed to the vehicle
 //   bus at which runs at 1 Mbps.
+//
+//   Only a single charger is supported. The common library's charger node always uses the charger's default CAN address, so
+//   chargers connected in parallel can't be told apart. Sharing the load across multiple chargers is deferred until the
+//   library supports a per-node address.
 
 // Includes -------------------------------------------------------------------------------------------------------------------
 
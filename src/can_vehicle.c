@@ -4,6 +4,8 @@
 // Includes
 #include "can/can_thread.h"
 #include "can/receive.h"
+#include "can/transfer.h"
+#include "can/transmit_thread.h"
 
 // Threads --------------------------------------------------------------------------------------------------------------------
 
@@ -42,6 +44,9 @@ static const canThreadConfig_t CAN1_RX_THREAD_CONFIG =
 
 bool canVehicleInit (tprio_t priority)
 {
+	// Only accept the messages handled by the BMS, the rest of the vehicle bus is ignored in hardware.
+	receiveSetFilters (false);
+
 	// CAN 1 driver initialization
 	if (canStart (&CAND1, &CAN1_CONFIG) != MSG_OK)
 		return false;
@@ -52,5 +57,11 @@ bool canVehicleInit (tprio_t priority)
 	// Create the CAN RX thread
 	canThreadStart (can1RxThreadWa, sizeof (can1RxThreadWa), priority, &CAN1_RX_THREAD_CONFIG);
 
+	// Create the CAN TX thread
+	transmitThreadStart (priority, &CAND1);
+
+	// Create the CAN transfer thread
+	transferThreadStart (priority);
+
 	return true;
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+// Header
+#include "cell_model.h"
+
+// Includes
+#include "peripherals.h"
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+float cellModelStateOfCharge (float voltage)
+{
+	const float* curve = physicalEepromMap->ocvVoltages;
+	if (!(voltage > curve [0]))
+		return 0.0f;
+
+	// Note the curve is non-decreasing, so the first point at or above the voltage bounds its segment.
+	for (uint16_t index = 1; index < EEPROM_OCV_POINT_COUNT; ++index)
+	{
+		if (voltage <= curve [index])
+		{
+			float fraction = (voltage - curve [index - 1]) / (curve [index] - curve [index - 1]);
+			return (index - 1 + fraction) / (EEPROM_OCV_POINT_COUNT - 1);
+		}
+	}
+
+	return 1.0f;
+}
+
+float cellModelCapacity (void)
+{
+	return physicalEepromMap->cellCapacity * 1000.0f;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef CELL_MODEL_H
+#define CELL_MODEL_H
+
+// Cell Model -----------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Model of the pack's cells, as configured in the EEPROM (OCV curve and capacity). Used to convert between cell
+//   voltages and charge for balancing and charging.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdint.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Calculates the state of charge of a cell from its open-circuit voltage, by interpolating the OCV curve.
+ * @param voltage The voltage of the cell.
+ * @return The state of charge, from 0 to 1.
+ */
+float cellModelStateOfCharge (float voltage);
+
+/**
+ * @brief Gets the capacity of each cell.
+ * @return The capacity, in mAh.
+ */
+float cellModelCapacity (void);
+
+#endif // CELL_MODEL_H
\ No newline at end of file
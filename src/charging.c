@@ -0,0 +1,200 @@
+// Header
+#include "charging.h"
+
+// Includes
+#include "cell_model.h"
+#include "peripherals.h"
+
+// C Standard Library
+#include <math.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Bounds of the charger command period, in milliseconds. The upper bound is limited by the charger's timeout.
+#define COMMAND_PERIOD_MIN		100
+#define COMMAND_PERIOD_MAX		1000
+#define COMMAND_PERIOD_DEFAULT	500
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+chargingState_t chargingState = CHARGING_STATE_IDLE;
+
+float chargingCurrentRequest = 0.0f;
+
+float chargingCurrentAllowed = 0.0f;
+
+float chargingTimeToFull = 0.0f;
+
+float chargingEnergyToFull = 0.0f;
+
+/// @brief The integral term of the constant voltage loop, in amps.
+static float integral = 0.0f;
+
+/// @brief Indicates the constant voltage loop has regulated above the termination current since the current limit last
+/// constrained it. The charge may only be terminated while this is set, see @c chargingUpdate .
+static bool taperValid = false;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Evaluates the derating curve at a temperature, interpolating between its points. Temperatures outside of the curve
+ * are saturated to its end points.
+ * @param temperature The temperature to evaluate at, in celsius.
+ * @return The fraction of the current limit that is allowed, 0 if the temperature is invalid.
+ */
+static float derate (float temperature)
+{
+	const float* temperatures = physicalEepromMap->deratingTemperatures;
+	const float* factors = physicalEepromMap->deratingFactors;
+
+	if (isnan (temperature))
+		return 0.0f;
+
+	if (temperature <= temperatures [0])
+		return factors [0];
+
+	for (uint16_t index = 1; index < EEPROM_DERATING_POINT_COUNT; ++index)
+	{
+		if (temperature <= temperatures [index])
+		{
+			float fraction = (temperature - temperatures [index - 1]) / (temperatures [index] - temperatures [index - 1]);
+			return factors [index - 1] + fraction * (factors [index] - factors [index - 1]);
+		}
+	}
+
+	return factors [EEPROM_DERATING_POINT_COUNT - 1];
+}
+
+/**
+ * @brief Updates the estimates of the time and energy until the charge completes.
+ * @param snapshot The latest pack snapshot.
+ */
+static void estimate (const packSnapshot_t* snapshot)
+{
+	// The charge remaining, in mAh, is the charge needed to bring the highest cell to the target.
+	float stateOfCharge = cellModelStateOfCharge (snapshot->cellVoltageMax);
+	float stateOfChargeTarget = cellModelStateOfCharge (physicalEepromMap->chargingCellVoltageTarget);
+	float charge = (stateOfChargeTarget - stateOfCharge) * cellModelCapacity ();
+	if (!(charge > 0.0f) || chargingState == CHARGING_STATE_COMPLETE)
+		charge = 0.0f;
+
+	// Note the charge is the same for every cell in series, so the energy scales with the pack voltage.
+	chargingEnergyToFull = charge / 1000.0f * snapshot->packVoltage;
+
+	// Note 1 mAh is 3.6 A*s.
+	if (charge == 0.0f)
+		chargingTimeToFull = 0.0f;
+	else if (chargingCurrentRequest > 0.0f)
+		chargingTimeToFull = charge * 3.6f / chargingCurrentRequest;
+	else
+		chargingTimeToFull = INFINITY;
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+uint16_t chargingCommandPeriod (void)
+{
+	uint16_t period = physicalEepromMap->chargingCommandPeriod;
+	if (period < COMMAND_PERIOD_MIN || period > COMMAND_PERIOD_MAX)
+		return COMMAND_PERIOD_DEFAULT;
+
+	return period;
+}
+
+void chargingStop (void)
+{
+	chargingState = CHARGING_STATE_IDLE;
+	chargingCurrentRequest = 0.0f;
+	chargingCurrentAllowed = 0.0f;
+	chargingTimeToFull = INFINITY;
+	chargingEnergyToFull = 0.0f;
+	integral = 0.0f;
+	taperValid = false;
+}
+
+float chargingUpdate (const packSnapshot_t* snapshot, float period, bool chargerAvailable)
+{
+	// Derate the current limit based on the coldest and hottest temperatures.
+	float deratingFactor = derate (snapshot->temperatureMin);
+	float deratingFactorMax = derate (snapshot->temperatureMax);
+	if (deratingFactorMax < deratingFactor)
+		deratingFactor = deratingFactorMax;
+
+	// Calculate the maximum requestable current, based on the power limit. Nothing may be requested while the charger is
+	// unavailable. Saturate based on the derated current limit.
+	float powerLimit = chargerAvailable ? physicalEepromMap->chargingPowerLimit : 0.0f;
+	float currentLimit = powerLimit / snapshot->packVoltage;
+	if (currentLimit > physicalEepromMap->chargingCurrentLimit * deratingFactor)
+		currentLimit = physicalEepromMap->chargingCurrentLimit * deratingFactor;
+
+	// Nothing may be requested if the limit can't be determined (ex. a pack voltage of 0 or NaN). Note the negated comparisons
+	// also catch NaN.
+	if (!(snapshot->packVoltage > 0.0f) || !(currentLimit > 0.0f))
+		currentLimit = 0.0f;
+
+	chargingCurrentAllowed = currentLimit;
+
+	float error = physicalEepromMap->chargingCellVoltageTarget - snapshot->cellVoltageMax;
+
+	switch (chargingState)
+	{
+	case CHARGING_STATE_IDLE:
+	case CHARGING_STATE_CONSTANT_CURRENT:
+		chargingState = CHARGING_STATE_CONSTANT_CURRENT;
+		if (error > 0.0f)
+		{
+			chargingCurrentRequest = currentLimit;
+			break;
+		}
+
+		// The target has been reached, start the taper from the current request. Note if charging starts with the cells
+		// already at the target, the request is 0, so charging completes immediately.
+		chargingState = CHARGING_STATE_CONSTANT_VOLTAGE;
+		integral = chargingCurrentRequest;
+		taperValid = false;
+		// Fallthrough
+
+	case CHARGING_STATE_CONSTANT_VOLTAGE:
+		// Integrate the error, saturating the integral to prevent windup.
+		integral += physicalEepromMap->chargingIntegralGain * error * period;
+		if (integral > currentLimit)
+		{
+			// The limit pulls the integral down with it (ex. derating, or a charger dropping out), so the taper must be
+			// re-established once the limit recovers.
+			integral = currentLimit;
+			taperValid = false;
+		}
+		if (!(integral > 0.0f))
+			integral = 0.0f;
+
+		// The taper is established once the loop regulates above the termination current, with the limit above it.
+		float threshold = physicalEepromMap->chargingThreshold;
+		if (!(currentLimit > threshold))
+			taperValid = false;
+		else if (integral > threshold)
+			taperValid = true;
+
+		chargingCurrentRequest = integral + physicalEepromMap->chargingProportionalGain * error;
+		if (!(chargingCurrentRequest > 0.0f))
+			chargingCurrentRequest = 0.0f;
+		if (chargingCurrentRequest > currentLimit)
+			chargingCurrentRequest = currentLimit;
+
+		// Terminate once the taper reaches the termination current. The integral is used as the proportional term is noisy.
+		// Note the charge isn't terminated unless the taper is established, as a low integral is otherwise due to the limit
+		// (ex. a hot pack) rather than the cells filling.
+		if (taperValid && !(integral > threshold))
+		{
+			chargingState = CHARGING_STATE_COMPLETE;
+			chargingCurrentRequest = 0.0f;
+		}
+		break;
+
+	case CHARGING_STATE_COMPLETE:
+		chargingCurrentRequest = 0.0f;
+		break;
+	}
+
+	estimate (snapshot);
+	return chargingCurrentRequest;
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#ifndef CHARGING_H
+#define CHARGING_H
+
+// Charge Controller ----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Closed-loop control of the current requested from the charger, based on the pack's maximum cell voltage.
+//   Charging proceeds in three stages:
+//   - Constant current: The maximum current (as limited by the charging current and power limits) is requested until the
+//     maximum cell voltage reaches its target.
+//   - Constant voltage: A PI loop regulates the current request to hold the maximum cell voltage at its target, so the request
+//     tapers as the cells fill.
+//   - Complete: Once the tapered current falls to the termination current (the charging threshold), the charger is put to
+//     sleep. Charging only restarts after it has been stopped (ex. disabled or faulted) and started again. The taper only
+//     counts once the loop has regulated above the termination current since the current limit last constrained it, so a
+//     temporary limit (ex. derating, or the charger dropping out) can't terminate the charge early.
+//
+//   If the current limit can't be determined (ex. the pack voltage or every temperature is invalid), nothing is requested.
+//
+//   Note the pack voltage limit is still requested from the charger, acting as a backstop to the cell-level control.
+//
+//   While the charger is unavailable (its status messages are timed out or report a fault), the current limit is 0.
+//
+//   The current limit is derated based on the pack's temperature. The derating curve maps a temperature to the fraction of the
+//   current limit that is allowed, which is evaluated at both the minimum and maximum thermistor temperatures, so the curve
+//   covers both cold and hot charging. This way charging slows down smoothly as the pack heats up, rather than running at full
+//   current until an overtemperature fault stops it.
+//
+//   The time and energy remaining until the charge completes are estimated from the state of charge of the highest cell (as
+//   it is the cell that terminates the charge), using the cell model. Note these are estimates, as the cell voltage is measured
+//   under load and the current request tapers during the constant voltage stage.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "pack_snapshot.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	CHARGING_STATE_IDLE					= 0,	// Not charging.
+	CHARGING_STATE_CONSTANT_CURRENT		= 1,	// Requesting the maximum current.
+	CHARGING_STATE_CONSTANT_VOLTAGE		= 2,	// Regulating the maximum cell voltage.
+	CHARGING_STATE_COMPLETE				= 3		// Charge terminated.
+} chargingState_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The state of the charge controller.
+extern chargingState_t chargingState;
+
+/// @brief The current requested from the charger, in amps.
+extern float chargingCurrentRequest;
+
+/// @brief The maximum current that may be requested, after derating, in amps.
+extern float chargingCurrentAllowed;
+
+/// @brief The estimated time until the charge completes, in seconds. Infinite if no current is being requested.
+extern float chargingTimeToFull;
+
+/// @brief The estimated energy until the charge completes, in watt-hours.
+extern float chargingEnergyToFull;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Gets the period of the charger commands, as configured in the EEPROM. The chargers are commanded at this rate,
+ * independent of the sample rate.
+ * @return The period, in milliseconds. If the EEPROM value is out of range, the default is used.
+ */
+uint16_t chargingCommandPeriod (void);
+
+/**
+ * @brief Stops the charge controller, returning it to the idle state. Should be called whenever charging is stopped.
+ */
+void chargingStop (void);
+
+/**
+ * @brief Updates the charge controller. Should be called once per new pack snapshot while charging.
+ * @param snapshot The latest pack snapshot.
+ * @param period The time since the previous update, in seconds.
+ * @param chargerAvailable Indicates the charger is available. If false, nothing is requested.
+ * @return The current to request from the charger, in amps. 0 once charging is complete.
+ */
+float chargingUpdate (const packSnapshot_t* snapshot, float period, bool chargerAvailable);
+
+#endif // CHARGING_H
\ No newline at end of file
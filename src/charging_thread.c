@@ -0,0 +1,114 @@
+// Header
+#include "charging_thread.h"
+
+// Includes
+#include "can_charger.h"
+#include "charging.h"
+#include "pack_snapshot.h"
+#include "peripherals.h"
+#include "can/transmit.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief Event signalled to the thread when a new pack snapshot is published.
+#define SAMPLE_EVENT		EVENT_MASK (0)
+
+/// @brief The maximum age of the pack snapshot before charging is stopped.
+#define SAMPLE_TIMEOUT		TIME_MS2I (1000)
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+static thread_t* thread = NULL;
+
+// Threads --------------------------------------------------------------------------------------------------------------------
+
+static THD_WORKING_AREA (chargingThreadWa, 512);
+void chargingThread (void* arg)
+{
+	(void) arg;
+	chRegSetThreadName ("charging");
+
+	// Copy of the latest pack state. Static as the snapshot is too large for the stack.
+	static packSnapshot_t snapshot;
+
+	float current = 0.0f;
+	systime_t timePrevious = chVTGetSystemTimeX ();
+	systime_t timeCommand = timePrevious;
+	bool commandEnabled = false;
+	while (true)
+	{
+		// Wait for a new sample, or until the next command is due. The period is read every cycle so that changes apply without
+		// a restart.
+		sysinterval_t commandPeriod = TIME_MS2I (chargingCommandPeriod ());
+		sysinterval_t commandElapsed = chTimeDiffX (timeCommand, chVTGetSystemTimeX ());
+		sysinterval_t timeout = commandElapsed < commandPeriod ? commandPeriod - commandElapsed : TIME_IMMEDIATE;
+		eventmask_t events = chEvtWaitAnyTimeout (SAMPLE_EVENT, timeout);
+		systime_t timeCurrent = chVTGetSystemTimeX ();
+
+		packSnapshotRead (&snapshot);
+
+		charging = physicalEepromMap->chargingEnabled;
+		bool sampleStale = chTimeDiffX (snapshot.timestamp, timeCurrent) > SAMPLE_TIMEOUT;
+		if (snapshot.prechargeComplete && !snapshot.bmsFault && charging && !sampleStale)
+		{
+			// Only update the controller on new samples, using the actual time between them.
+			if (events & SAMPLE_EVENT)
+			{
+				float period = TIME_I2MS (chTimeDiffX (timePrevious, timeCurrent)) / 1000.0f;
+				timePrevious = timeCurrent;
+
+				// Regulate the current request from the max cell voltage. Nothing is requested while the charger is
+				// unavailable, that is, while its status messages are timed out or report a fault. The controller reads its
+				// config from the working memory map, so the peripheral mutex is held to keep a commit from replacing the map
+				// mid-update, see peripheralsApplyMap.
+				bool chargerAvailable = charger.state == CAN_NODE_VALID;
+				chMtxLock (&peripheralMutex);
+				current = chargingUpdate (&snapshot, period, chargerAvailable);
+				chMtxUnlock (&peripheralMutex);
+			}
+		}
+		else
+		{
+			// Stop the charge controller
+			chargingStop ();
+			current = 0.0f;
+			timePrevious = timeCurrent;
+		}
+
+		// Command the charger once per command period, regardless of the sample rate, so it neither times out nor is flooded.
+		// Disabling it (stopping or completing the charge) is commanded immediately.
+		bool enabled = chargingState != CHARGING_STATE_COMPLETE && chargingState != CHARGING_STATE_IDLE;
+		bool commandDue = chTimeDiffX (timeCommand, timeCurrent) >= commandPeriod;
+		if (!commandDue && !(commandEnabled && !enabled))
+			continue;
+
+		timeCommand = timeCurrent;
+		commandEnabled = enabled;
+
+		// Send the power request, or disable the charger. Note the charger is started up even while it is unavailable, so it
+		// responds once it is back.
+		if (enabled)
+			tcChargerSendCommand (&charger, TC_WORKING_MODE_STARTUP, physicalEepromMap->chargingVoltageLimit, current,
+				TIME_MS2I (100));
+		else
+			tcChargerSendCommand (&charger, TC_WORKING_MODE_SLEEP, 0, 0, TIME_MS2I (100));
+
+		// Broadcast the charge controller's state and estimates.
+		transmitChargingMessage ();
+	}
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void chargingThreadStart (tprio_t priority)
+{
+	thread = chThdCreateStatic (chargingThreadWa, sizeof (chargingThreadWa), priority, chargingThread, NULL);
+}
+
+void chargingThreadSignalSample (void)
+{
+	if (thread == NULL)
+		return;
+
+	chEvtSignal (thread, SAMPLE_EVENT);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef CHARGING_THREAD_H
+#define CHARGING_THREAD_H
+
+// Charging Thread ------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Thread running the charge controller while the accumulator is on the charger. The thread is woken by the
+//   monitor thread each time a new pack snapshot is published, so the controller is updated within one sample period of the
+//   measurement. The availability of the charger is re-evaluated on each update.
+//
+//   The charger is commanded from this thread, outside of the peripheral mutex, so a CAN timeout while commanding it cannot
+//   delay the monitor thread. The charger is commanded once per command period, independent of the sample rate, with the
+//   latest request. This keeps it from timing out, without flooding the bus when sampling is fast. Disabling the charger (the
+//   charge stopping or completing) is commanded immediately. If the snapshot becomes stale, charging is stopped.
+//
+//   See charging.h for details of the charge controller.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "ch.h"
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Starts the charging thread.
+ * @param priority The priority of the thread.
+ */
+void chargingThreadStart (tprio_t priority);
+
+/**
+ * @brief Signals the charging thread that a new pack snapshot has been published. Does nothing if the thread is not running.
+ */
+void chargingThreadSignalSample (void);
+
+#endif // CHARGING_THREAD_H
\ No newline at end of file
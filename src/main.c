@@ -16,19 +16,24 @@
 // Includes -------------------------------------------------------------------------------------------------------------------
 
 // Includes
+#include "balancing.h"
 #include "can_vehicle.h"
 #include "can_charger.h"
+#include "charging_thread.h"
 #include "debug.h"
 #include "monitor_thread.h"
+#include "pack_snapshot.h"
 #include "peripherals.h"
+#include "profiler.h"
 #include "watchdog.h"
-#include "algorithm/sort.h"
 
 // ChibiOS
 #include "hal.h"
 
-// C Standard Library
-#include <float.h>
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The period of the balancing loop, in milliseconds.
+#define BALANCING_PERIOD 500
 
 // Interrupts -----------------------------------------------------------------------------------------------------------------
 
@@ -61,6 +66,9 @@ int main (void)
 		while (true);
 	}
 
+	// Record the boot time taken by the peripherals (mostly the EEPROM load).
+	profilerRecordBoot (PROFILER_BOOT_PERIPHERALS);
+
 	// Start the watchdog timer.
 	watchdogStart ();
 
@@ -90,73 +98,57 @@ int main (void)
 			while (true);
 		}
 
-		// Start the monitoring thread.
+		// Start the monitoring and charging threads.
 		monitorThreadStart (NORMALPRIO);
+		chargingThreadStart (NORMALPRIO);
 
-		// Main loop
+		// Main loop, balancing the cells. The chargers are controlled by the charging thread.
+		balancingLedgerLoad ();
+		balancingReset ();
 		systime_t timePrevious = chVTGetSystemTimeX ();
 		while (true)
 		{
-			chMtxLock (&peripheralMutex);
+			// Copy the latest pack state. Static as the snapshot is too large for the stack.
+			static packSnapshot_t snapshot;
+			packSnapshotRead (&snapshot);
 
-			balancing = physicalEepromMap->balancingEnabled;
-			if (prechargeComplete && !bmsFault && balancing)
-			{
-				// Search the pack for the min cell voltage
-				float minVoltage = ltcs [0].cellVoltages [0];
-				for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
-					for (uint16_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
-						if (ltcs [ltc].cellVoltages [cell] < minVoltage)
-							minVoltage = ltcs [ltc].cellVoltages [cell];
-
-				// Only balance the highest 4 deltas. This is to compensate for the LTCs overheating.
-				uint8_t balanceCount = 4;
-				float sortedVoltages [LTC6811_CELL_COUNT];
-				uint8_t sortedIndices [LTC6811_CELL_COUNT];
-				for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
-				{
-					// Cursed sorting algorithm.
-					sortValues (ltcs [ltc].cellVoltages, LTC6811_CELL_COUNT, sortedVoltages, sortedIndices, balanceCount, >, FLT_MIN);
+			float period = BALANCING_PERIOD / 1000.0f;
 
-					for (uint16_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
-						ltcs [ltc].cellsDischarging [cell] = false;
+			// Determine which cells to discharge. This is done using the snapshot, so the peripheral mutex is only held to
+			// apply the result.
+			static uint16_t dischargeMasks [LTC_COUNT];
 
-					for (uint16_t cell = 0; cell < balanceCount; ++cell)
-						ltcs [ltc].cellsDischarging [sortedIndices [cell]] =
-							ltcs [ltc].cellVoltages [sortedIndices [cell]] - minVoltage > physicalEepromMap->balancingThreshold;
-				}
-			}
-			else
-			{
-				for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
-					for (uint16_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
-						ltcs [ltc].cellsDischarging [cell] = false;
-			}
+			// Account for the charge removed by the previous cycle's discharging.
+			balancingConsume (snapshot.dischargeTimes, snapshot.cellVoltages);
 
-			charging = physicalEepromMap->chargingEnabled;
-			if (prechargeComplete && !bmsFault && charging)
+			balancing = physicalEepromMap->balancingEnabled;
+			if (snapshot.prechargeComplete && !snapshot.bmsFault && balancing)
 			{
-				// Calculate the maximum requestable current, based on the power limit.
-				float currentLimit = physicalEepromMap->chargingPowerLimit / packVoltage;
-
-				// Saturate based on the current limit.
-				if (currentLimit > physicalEepromMap->chargingCurrentLimit)
-					currentLimit = physicalEepromMap->chargingCurrentLimit;
-
-				// Send the power request.
-				tcChargerSendCommand (&charger, TC_WORKING_MODE_STARTUP,
-					physicalEepromMap->chargingVoltageLimit, currentLimit, TIME_MS2I (100));
+				// The number of cells each LTC discharges is regulated from its die temperature, so the LTCs don't overheat.
+				uint8_t balanceCounts [LTC_COUNT];
+				balancingRegulate (snapshot.dieTemperatures, period, balanceCounts);
+
+				// Discharge the cells with the largest remaining budgets, re-planning once they are spent.
+				float threshold = balancingSchedule (snapshot.cellVoltages, snapshot.cellVoltageMin);
+				balancingPlan (balancingLedger.budgets, LTC_COUNT, balanceCounts, threshold, dischargeMasks);
+				balancingLedgerStore (false);
 			}
 			else
 			{
-				// Disable the charger
-				tcChargerSendCommand (&charger, TC_WORKING_MODE_SLEEP, 0, 0, TIME_MS2I (100));
+				balancingReset ();
+				for (uint16_t ltc = 0; ltc < LTC_COUNT; ++ltc)
+					dischargeMasks [ltc] = 0;
+
+				// Persist the progress of the plan now that balancing has stopped.
+				balancingLedgerStore (true);
 			}
 
+			chMtxLock (&peripheralMutex);
+			balancingApply (dischargeMasks);
 			chMtxUnlock (&peripheralMutex);
 
 			// Sleep until the next loop
-			chThdSleepUntilWindowed (timePrevious, chTimeAddX (timePrevious, TIME_MS2I (500)));
+			chThdSleepUntilWindowed (timePrevious, chTimeAddX (timePrevious, TIME_MS2I (BALANCING_PERIOD)));
 			timePrevious = chVTGetSystemTimeX ();
 		}
 	}
@@ -3,13 +3,353 @@
 
 // Includes
 #include "peripherals.h"
+#include "pack_snapshot.h"
+#include "profiler.h"
+#include "charging_thread.h"
 #include "can/transmit.h"
 #include "watchdog.h"
 
+// C Standard Library
+#include <math.h>
+
 // Constants ------------------------------------------------------------------------------------------------------------------
 
-// TODO(Barach): Validate this is being achieved.
-#define BMS_THREAD_PERIOD TIME_MS2I (250)
+/// @brief Bounds of the cell voltage loop's period, in milliseconds. The upper bound is limited by the watchdog timeout.
+#define CELL_SAMPLE_PERIOD_MIN		20
+#define CELL_SAMPLE_PERIOD_MAX		500
+#define CELL_SAMPLE_PERIOD_DEFAULT	250
+
+/// @brief Bounds of the temperature loop's period, in milliseconds.
+#define TEMPERATURE_SAMPLE_PERIOD_MAX		10000
+#define TEMPERATURE_SAMPLE_PERIOD_DEFAULT	250
+
+/// @brief Bounds of the open-wire test's period, in milliseconds.
+#define OPEN_WIRE_TEST_PERIOD_MAX			60000
+#define OPEN_WIRE_TEST_PERIOD_DEFAULT		250
+
+/// @brief Upper bound of the balancing relaxation time, in milliseconds. Also limited to half of the cell voltage loop's period.
+#define RELAXATION_TIME_MAX			100
+
+/// @brief Bounds of the fault time, in milliseconds.
+#define FAULT_TIME_MAX				10000
+#define FAULT_TIME_DEFAULT			2000
+
+/// @brief Upper bound of the fault count, the range of the LTC driver's fault count.
+#define FAULT_COUNT_MAX				UINT8_MAX
+
+/// @brief Bounds of the bulk CAN message period, in milliseconds.
+#define CAN_BULK_PERIOD_MAX			10000
+#define CAN_BULK_PERIOD_DEFAULT		250
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The discharge state of each cell while discharging is suspended, see @c suspendDischarge .
+static bool suspendedCells [LTC_COUNT][LTC6811_CELL_COUNT];
+
+/// @brief Indicates discharging is suspended, meaning @c suspendedCells holds the discharge state.
+static bool dischargeSuspended = false;
+
+/// @brief The total time each cell has discharged for, in microseconds, see @c accumulateDischarge .
+static uint32_t dischargeTimes [LTC_COUNT][LTC6811_CELL_COUNT];
+
+/// @brief Bitmask of each LTC's discharging cells, as of the last config write, see @c recordDischarge .
+static uint16_t dischargeMasks [LTC_COUNT];
+
+/// @brief The time discharge was last accumulated or recorded.
+static systime_t dischargeTime;
+
+/// @brief The number of samples each cell has been reported undervoltage or overvoltage in, see @c countCellFaults .
+static uint16_t cellFaultCounts [LTC_COUNT][LTC6811_CELL_COUNT];
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Gets the number of cell voltage loop cycles that make up the specified period.
+ * @param period The period to divide, in milliseconds.
+ * @param cellPeriod The period of the cell voltage loop, in milliseconds.
+ * @return The number of cycles, minimum of 1.
+ */
+static uint16_t getPeriodDivider (uint16_t period, uint16_t cellPeriod)
+{
+	uint16_t divider = period / cellPeriod;
+	return divider != 0 ? divider : 1;
+}
+
+/**
+ * @brief Gets a period from the EEPROM, falling back to its default if out of range.
+ * @param period The configured period, in milliseconds.
+ * @param max The maximum valid period, in milliseconds.
+ * @param defaultPeriod The default period, in milliseconds.
+ * @return The period, in milliseconds.
+ */
+static uint16_t getPeriod (uint16_t period, uint16_t max, uint16_t defaultPeriod)
+{
+	if (period == 0 || period > max)
+		return defaultPeriod;
+
+	return period;
+}
+
+/**
+ * @brief Checks whether the last temperature sample reported a fault, that is a thermistor under / overtemperature or an LTC
+ * self-test fault. Must be called with the peripheral mutex locked.
+ * @return True if any fault was reported, false otherwise.
+ */
+static bool temperatureFaultReported (void)
+{
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+		for (uint16_t thermistorIndex = 0; thermistorIndex < LTC6811_GPIO_COUNT; ++thermistorIndex)
+			if (thermistors [ltcIndex][thermistorIndex].undertemperatureFault
+				|| thermistors [ltcIndex][thermistorIndex].overtemperatureFault)
+				return true;
+
+	return ltc6811SelfTestFault (ltcBottom);
+}
+
+/**
+ * @brief Checks whether the last open-wire test found an open sense-line. Must be called with the peripheral mutex locked.
+ * @return True if any sense-line was found open, false otherwise.
+ */
+static bool openWireFaultReported (void)
+{
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+		for (uint16_t wireIndex = 0; wireIndex < LTC6811_CELL_COUNT + 1; ++wireIndex)
+			if (ltcs [ltcIndex].openWireFaults [wireIndex])
+				return true;
+
+	return false;
+}
+
+/**
+ * @brief Counts the cells reported undervoltage or overvoltage by the last cell voltage sample. Must be called with the
+ * peripheral mutex locked.
+ */
+static void countCellFaults (void)
+{
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+			if ((ltcs [ltcIndex].undervoltageFaults [cellIndex] || ltcs [ltcIndex].overvoltageFaults [cellIndex])
+				&& cellFaultCounts [ltcIndex][cellIndex] != UINT16_MAX)
+				++cellFaultCounts [ltcIndex][cellIndex];
+}
+
+/**
+ * @brief Records the cells that are discharging, following a write of the LTCs' configuration. Must be called with the
+ * peripheral mutex locked.
+ */
+static void recordDischarge (void)
+{
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+	{
+		dischargeMasks [ltcIndex] = 0;
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+			dischargeMasks [ltcIndex] |= ltcs [ltcIndex].cellsDischarging [cellIndex] << cellIndex;
+	}
+
+	dischargeTime = chVTGetSystemTimeX ();
+}
+
+/**
+ * @brief Adds the time since discharge was last recorded (or accumulated) to the discharge time of each cell that was
+ * discharging. Should be called before discharging is suspended, so the suspension is not counted.
+ */
+static void accumulateDischarge (void)
+{
+	systime_t timeCurrent = chVTGetSystemTimeX ();
+	uint32_t elapsed = TIME_I2US (chTimeDiffX (dischargeTime, timeCurrent));
+	dischargeTime = timeCurrent;
+
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+			if ((dischargeMasks [ltcIndex] >> cellIndex) & 1)
+				dischargeTimes [ltcIndex][cellIndex] += elapsed;
+}
+
+/**
+ * @brief Suspends cell discharging, so the balancing current does not bias the cell voltage measurements. The cells must then
+ * be given time to relax, see @c getRelaxationTime . Must be called with the peripheral mutex locked.
+ * @return True if discharging was suspended, false if no cells were discharging.
+ */
+static bool suspendDischarge (void)
+{
+	bool discharging = false;
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+	{
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+		{
+			suspendedCells [ltcIndex][cellIndex] = ltcs [ltcIndex].cellsDischarging [cellIndex];
+			discharging |= ltcs [ltcIndex].cellsDischarging [cellIndex];
+			ltcs [ltcIndex].cellsDischarging [cellIndex] = false;
+		}
+	}
+
+	if (!discharging)
+		return false;
+
+	ltc6811WriteConfig (ltcBottom);
+	dischargeSuspended = true;
+	return true;
+}
+
+/**
+ * @brief Gets the time the cells are given to relax after discharging is suspended, as configured in the EEPROM.
+ * @param cellPeriod The period of the cell voltage loop, in milliseconds.
+ * @return The time, in milliseconds. Saturated to @c RELAXATION_TIME_MAX and half of the cell voltage loop's period.
+ */
+static uint16_t getRelaxationTime (uint16_t cellPeriod)
+{
+	uint16_t relaxationTime = physicalEepromMap->balancingRelaxationTime;
+	if (relaxationTime > RELAXATION_TIME_MAX)
+		relaxationTime = RELAXATION_TIME_MAX;
+	if (relaxationTime > cellPeriod / 2)
+		relaxationTime = cellPeriod / 2;
+
+	return relaxationTime;
+}
+
+/**
+ * @brief Restores the discharge state saved by @c suspendDischarge . Must be called with the peripheral mutex locked. Note
+ * this does not write the LTCs' configuration.
+ */
+static void resumeDischarge (void)
+{
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+			ltcs [ltcIndex].cellsDischarging [cellIndex] = suspendedCells [ltcIndex][cellIndex];
+
+	dischargeSuspended = false;
+}
+
+/**
+ * @brief Checks whether a thermistor's reading can be trusted.
+ * @param thermistor The thermistor to check.
+ * @return True if the sensor's last sample was valid, false otherwise.
+ */
+static bool thermistorValid (const thermistorPulldown_t* thermistor)
+{
+	return thermistor->state == ANALOG_SENSOR_VALID && !isnan (thermistor->temperature);
+}
+
+/**
+ * @brief Publishes the current state of the peripherals and global state as the pack snapshot. Must be called with the
+ * peripheral mutex locked.
+ */
+static void publishSnapshot (void)
+{
+	packSnapshot_t* snapshot = packSnapshotBeginWrite ();
+
+	// Pack statistics, accumulated in the same pass as the copy.
+	float cellVoltageSum = 0.0f;
+	float temperatureSum = 0.0f;
+	uint16_t temperatureCount = 0;
+	snapshot->cellVoltageMin = ltcs [0].cellVoltages [0];
+	snapshot->cellVoltageMax = ltcs [0].cellVoltages [0];
+	snapshot->cellVoltageMinIndex = 0;
+	snapshot->cellVoltageMaxIndex = 0;
+	snapshot->temperatureMin = INFINITY;
+	snapshot->temperatureMax = -INFINITY;
+	snapshot->temperatureMinIndex = 0;
+	snapshot->temperatureMaxIndex = 0;
+
+	for (uint16_t ltcIndex = 0; ltcIndex < LTC_COUNT; ++ltcIndex)
+	{
+		ltc6811_t* ltc = &ltcs [ltcIndex];
+
+		snapshot->undervoltageFaults [ltcIndex] = 0;
+		snapshot->overvoltageFaults [ltcIndex] = 0;
+		snapshot->cellsDischarging [ltcIndex] = 0;
+		for (uint16_t cellIndex = 0; cellIndex < LTC6811_CELL_COUNT; ++cellIndex)
+		{
+			snapshot->cellVoltages [ltcIndex][cellIndex] = ltc->cellVoltages [cellIndex];
+			snapshot->undervoltageFaults [ltcIndex] |= ltc->undervoltageFaults [cellIndex] << cellIndex;
+			snapshot->overvoltageFaults [ltcIndex] |= ltc->overvoltageFaults [cellIndex] << cellIndex;
+			snapshot->cellsDischarging [ltcIndex] |= ltc->cellsDischarging [cellIndex] << cellIndex;
+			snapshot->dischargeTimes [ltcIndex][cellIndex] = dischargeTimes [ltcIndex][cellIndex];
+			snapshot->cellFaultCounts [ltcIndex][cellIndex] = cellFaultCounts [ltcIndex][cellIndex];
+
+			float voltage = ltc->cellVoltages [cellIndex];
+			cellVoltageSum += voltage;
+			if (voltage < snapshot->cellVoltageMin)
+			{
+				snapshot->cellVoltageMin = voltage;
+				snapshot->cellVoltageMinIndex = ltcIndex * LTC6811_CELL_COUNT + cellIndex;
+			}
+			if (voltage > snapshot->cellVoltageMax)
+			{
+				snapshot->cellVoltageMax = voltage;
+				snapshot->cellVoltageMaxIndex = ltcIndex * LTC6811_CELL_COUNT + cellIndex;
+			}
+		}
+
+		snapshot->openWireFaults [ltcIndex] = 0;
+		for (uint16_t wireIndex = 0; wireIndex < LTC6811_CELL_COUNT + 1; ++wireIndex)
+			snapshot->openWireFaults [ltcIndex] |= ltc->openWireFaults [wireIndex] << wireIndex;
+
+		snapshot->ltcStates [ltcIndex] = (uint8_t) ltc->state;
+		snapshot->dieTemperatures [ltcIndex] = ltc->dieTemperature;
+
+		snapshot->undertemperatureFaults [ltcIndex] = 0;
+		snapshot->overtemperatureFaults [ltcIndex] = 0;
+		for (uint16_t thermistorIndex = 0; thermistorIndex < LTC6811_GPIO_COUNT; ++thermistorIndex)
+		{
+			thermistorPulldown_t* thermistor = &thermistors [ltcIndex][thermistorIndex];
+			snapshot->temperatures [ltcIndex][thermistorIndex] = thermistor->temperature;
+			snapshot->undertemperatureFaults [ltcIndex] |= thermistor->undertemperatureFault << thermistorIndex;
+			snapshot->overtemperatureFaults [ltcIndex] |= thermistor->overtemperatureFault << thermistorIndex;
+
+			// Invalid sensors (open-circuit, shorted, or unsampled) are excluded from the statistics.
+			if (!thermistorValid (thermistor))
+				continue;
+
+			float temperature = thermistor->temperature;
+			temperatureSum += temperature;
+			++temperatureCount;
+			if (temperature < snapshot->temperatureMin)
+			{
+				snapshot->temperatureMin = temperature;
+				snapshot->temperatureMinIndex = ltcIndex * LTC6811_GPIO_COUNT + thermistorIndex;
+			}
+			if (temperature > snapshot->temperatureMax)
+			{
+				snapshot->temperatureMax = temperature;
+				snapshot->temperatureMaxIndex = ltcIndex * LTC6811_GPIO_COUNT + thermistorIndex;
+			}
+		}
+	}
+
+	snapshot->cellVoltageAverage = cellVoltageSum / CELL_COUNT;
+	if (temperatureCount != 0)
+	{
+		snapshot->temperatureAverage = temperatureSum / temperatureCount;
+	}
+	else
+	{
+		// No valid sensors, report the temperatures as unknown.
+		snapshot->temperatureMin = NAN;
+		snapshot->temperatureMax = NAN;
+		snapshot->temperatureAverage = NAN;
+	}
+
+	snapshot->packVoltage			= packVoltage;
+	snapshot->packCurrent			= currentSensor.value;
+	snapshot->bmsFault				= bmsFault;
+	snapshot->undervoltageFault		= undervoltageFault;
+	snapshot->overvoltageFault		= overvoltageFault;
+	snapshot->undertemperatureFault	= undertemperatureFault;
+	snapshot->overtemperatureFault	= overtemperatureFault;
+	snapshot->senseLineFault		= senseLineFault;
+	snapshot->isospiFault			= isospiFault;
+	snapshot->selfTestFault			= selfTestFault;
+	snapshot->charging				= charging;
+	snapshot->balancing				= balancing;
+	snapshot->shutdownLoopClosed	= shutdownLoopClosed;
+	snapshot->prechargeComplete		= prechargeComplete;
+	snapshot->shutdownLoopBlip		= shutdownLoopBlip;
+	snapshot->bmsFaultRelay			= bmsFaultRelay;
+	snapshot->imdFaultRelay			= imdFaultRelay;
+
+	packSnapshotPublish ();
+}
 
 // Threads --------------------------------------------------------------------------------------------------------------------
 
@@ -18,24 +358,123 @@ void monitorThread (void* arg)
 {
 	(void) arg;
 
+	// Number of cycles until each of the slower loops is due. Both start due so the first cycle samples everything.
+	uint16_t temperatureCountdown = 0;
+	uint16_t openWireCountdown = 0;
+	uint16_t canBulkCountdown = 0;
+
+	// Indicates one of the slower loops reported a fault, so runs every cycle until it clears. See monitorFaultCount.
+	bool temperatureConfirming = false;
+	bool openWireConfirming = false;
+
 	systime_t timePrevious = chVTGetSystemTimeX ();
 	while (true)
 	{
 		// Reset the watchdog.
 		watchdogReset ();
 
+		rtcnt_t timeCycleStart = profilerStart ();
+
+		// Get the loop rates. These are read every cycle so that changes apply without a restart.
+		uint16_t cellPeriod = monitorCellSamplePeriod ();
+		uint16_t temperaturePeriod = getPeriod (physicalEepromMap->temperatureSamplePeriod, TEMPERATURE_SAMPLE_PERIOD_MAX,
+			TEMPERATURE_SAMPLE_PERIOD_DEFAULT);
+		uint16_t openWirePeriod = getPeriod (physicalEepromMap->openWireTestPeriod, OPEN_WIRE_TEST_PERIOD_MAX,
+			OPEN_WIRE_TEST_PERIOD_DEFAULT);
+		uint16_t temperatureDivider = getPeriodDivider (temperaturePeriod, cellPeriod);
+		uint16_t openWireDivider = getPeriodDivider (openWirePeriod, cellPeriod);
+		uint16_t canBulkPeriod = getPeriod (physicalEepromMap->canBulkPeriod, CAN_BULK_PERIOD_MAX, CAN_BULK_PERIOD_DEFAULT);
+		uint16_t canBulkDivider = getPeriodDivider (canBulkPeriod, cellPeriod);
+		sysinterval_t period = TIME_MS2I (cellPeriod);
+
+		// Determine which of the slower loops are due. The open-wire test is pushed back a cycle if it would coincide with the
+		// temperature sampling, unless either is running every cycle.
+		bool temperatureDue = temperatureCountdown == 0 || temperatureConfirming;
+		bool openWireDue = (openWireCountdown == 0 || openWireConfirming)
+			&& (!temperatureDue || temperatureDivider == 1 || temperatureConfirming || openWireConfirming);
+
 		chMtxLock (&peripheralMutex);
+		rtcnt_t timeMutexStart = profilerStart ();
 
 		// Sample the LTCs
 		ltc6811ClearState (ltcBottom);
+
+		// Suspend discharging for the conversions, it is resumed by the config write once they are complete. The mutex is
+		// released while the cells relax, so other threads aren't stalled by the wait. Changes to the discharge state made in
+		// the meantime are applied on resume, see monitorSetCellDischarging.
+		rtcnt_t timeStart = profilerStart ();
+		accumulateDischarge ();
+		if (suspendDischarge ())
+		{
+			uint16_t relaxationTime = getRelaxationTime (cellPeriod);
+			if (relaxationTime != 0)
+			{
+				profilerStop (PROFILER_STAGE_MUTEX_HOLD, timeMutexStart);
+				chMtxUnlock (&peripheralMutex);
+
+				chThdSleepMilliseconds (relaxationTime);
+
+				chMtxLock (&peripheralMutex);
+				timeMutexStart = profilerStart ();
+			}
+
+			profilerStop (PROFILER_STAGE_RELAXATION, timeStart);
+		}
+
+		// Note the acquisition is measured as a whole, as well as by stage, as it bounds the minimum cell voltage loop period.
+		// Each of the LTC driver's calls starts its conversion, waits on it, and reads it back, so the next conversion can't be
+		// started during the readback. Pipelining the acquisition is deferred until the driver splits these steps.
+		rtcnt_t timeAcquisitionStart = profilerStart ();
+
+		timeStart = profilerStart ();
 		ltc6811SampleCells (ltcBottom);
-		ltc6811SampleStatus (ltcBottom);
+		profilerStop (PROFILER_STAGE_SAMPLE_CELLS, timeStart);
+		profilerRecordBoot (PROFILER_BOOT_FIRST_LTC_SAMPLE);
+
+		timeStart = profilerStart ();
 		ltc6811SampleCellVoltageFaults (ltcBottom);
-		ltc6811SampleGpio (ltcBottom);
+		countCellFaults ();
+		profilerStop (PROFILER_STAGE_CELL_FAULTS, timeStart);
+
+		if (temperatureDue)
+		{
+			timeStart = profilerStart ();
+			ltc6811SampleStatus (ltcBottom);
+			profilerStop (PROFILER_STAGE_SAMPLE_STATUS, timeStart);
 
-		// TODO(Barach): Manage balancing.
-		ltc6811OpenWireTest (ltcBottom);
+			timeStart = profilerStart ();
+			ltc6811SampleGpio (ltcBottom);
+			profilerStop (PROFILER_STAGE_SAMPLE_GPIO, timeStart);
+
+			temperatureCountdown = temperatureDivider;
+			temperatureConfirming = temperatureFaultReported ();
+		}
+
+		if (openWireDue)
+		{
+			timeStart = profilerStart ();
+			ltc6811OpenWireTest (ltcBottom);
+			profilerStop (PROFILER_STAGE_OPEN_WIRE_TEST, timeStart);
+
+			openWireCountdown = openWireDivider;
+			openWireConfirming = openWireFaultReported ();
+		}
+
+		// Resume discharging.
+		if (dischargeSuspended)
+			resumeDischarge ();
+
+		timeStart = profilerStart ();
 		ltc6811WriteConfig (ltcBottom);
+		recordDischarge ();
+		profilerStop (PROFILER_STAGE_WRITE_CONFIG, timeStart);
+		profilerStop (PROFILER_STAGE_ACQUISITION, timeAcquisitionStart);
+
+		if (temperatureCountdown != 0)
+			--temperatureCountdown;
+
+		if (openWireCountdown != 0)
+			--openWireCountdown;
 
 		// Update the global state
 
@@ -72,23 +511,46 @@ void monitorThread (void* arg)
 		imdFaultRelay = !palReadLine (LINE_IMD_FLT);
 
 		// Sample the current sensor
+		timeStart = profilerStart ();
 		stmAdcSample (&adc);
+		profilerStop (PROFILER_STAGE_SAMPLE_ADC, timeStart);
 
+		// Publish the new state for consumers outside of this thread.
+		publishSnapshot ();
+
+		profilerStop (PROFILER_STAGE_MUTEX_HOLD, timeMutexStart);
 		chMtxUnlock (&peripheralMutex);
 
+		// Wake the charge controller to act on the new sample.
+		chargingThreadSignalSample ();
+
 		// If a fault is present, open the shutdown loop.
 		bool fltLine = !bmsFault;
 		palWriteLine (LINE_BMS_FLT, fltLine);
 
-		// Transmit the CAN messages.
-		transmitBmsMessages (BMS_THREAD_PERIOD);
+		// Queue the CAN messages. The summary messages are sent every cycle, the bulk messages at their own rate.
+		bool canBulkDue = canBulkCountdown == 0;
+		if (canBulkDue)
+			canBulkCountdown = canBulkDivider;
+		--canBulkCountdown;
+
+		timeStart = profilerStart ();
+		transmitBmsMessages (canBulkDue);
+		profilerStop (PROFILER_STAGE_TRANSMIT, timeStart);
 
 		// Reset the blip status
 		if (shutdownLoopBlip && chTimeDiffX (shutdownLoopBlipTime, chVTGetSystemTimeX ()) < TIME_MS2I (1000))
 			shutdownLoopBlip = false;
 
+		profilerStop (PROFILER_STAGE_CYCLE, timeCycleStart);
+
+		// Count the cycle as an overrun if the period has already elapsed.
+		systime_t timeNext = chTimeAddX (timePrevious, period);
+		if (!chTimeIsInRangeX (chVTGetSystemTimeX (), timePrevious, timeNext))
+			profilerRecordOverrun ();
+
 		// Sleep until the next loop
-		chThdSleepUntilWindowed (timePrevious, chTimeAddX (timePrevious, BMS_THREAD_PERIOD));
+		chThdSleepUntilWindowed (timePrevious, timeNext);
 		timePrevious = chVTGetSystemTimeX ();
 	}
 }
@@ -97,5 +559,38 @@ void monitorThread (void* arg)
 
 void monitorThreadStart (tprio_t priority)
 {
+	profilerReset ();
+
 	chThdCreateStatic (monitorThreadWa, sizeof (monitorThreadWa), priority, monitorThread, NULL);
+}
+
+uint16_t monitorCellSamplePeriod (void)
+{
+	uint16_t period = physicalEepromMap->cellSamplePeriod;
+	if (period < CELL_SAMPLE_PERIOD_MIN || period > CELL_SAMPLE_PERIOD_MAX)
+		return CELL_SAMPLE_PERIOD_DEFAULT;
+
+	return period;
+}
+
+uint16_t monitorFaultCount (void)
+{
+	uint16_t faultTime = physicalEepromMap->faultTime;
+	if (faultTime == 0 || faultTime > FAULT_TIME_MAX)
+		faultTime = FAULT_TIME_DEFAULT;
+
+	uint16_t faultCount = getPeriodDivider (faultTime, monitorCellSamplePeriod ());
+	if (faultCount > FAULT_COUNT_MAX)
+		faultCount = FAULT_COUNT_MAX;
+
+	return faultCount;
+}
+
+void monitorSetCellDischarging (uint16_t ltcIndex, uint16_t cellIndex, bool discharging)
+{
+	// While suspended, the change is applied when discharging resumes.
+	if (dischargeSuspended)
+		suspendedCells [ltcIndex][cellIndex] = discharging;
+	else
+		ltcs [ltcIndex].cellsDischarging [cellIndex] = discharging;
 }
\ No newline at end of file
@@ -4,6 +4,38 @@
 // ChibiOS
 #include "ch.h"
 
+// C Standard Library
+#include <stdbool.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
 void monitorThreadStart (tprio_t priority);
 
+/**
+ * @brief Gets the period of the monitor thread's cell voltage loop, as configured in the EEPROM. The temperature loop and
+ * open-wire test run at integer multiples of this period.
+ * @return The period, in milliseconds. If the EEPROM value is out of range, the default is used.
+ */
+uint16_t monitorCellSamplePeriod (void);
+
+/**
+ * @brief Gets the number of consecutive samples a fault must be present for before it is reported. This is based on the
+ * configured fault time and the period of the cell voltage loop. Note the LTC driver applies the same count to every check,
+ * so once the temperature sampling or open-wire test reports a fault, it is repeated every cell voltage loop cycle until the
+ * fault clears. This way every check is debounced over the fault time, rather than a multiple of it.
+ * @return The number of samples. Saturated to the range of the LTC driver's fault count, in which case the fault time is
+ * shortened.
+ */
+uint16_t monitorFaultCount (void);
+
+/**
+ * @brief Sets whether a cell is discharging. If discharging is suspended for a measurement, the change is applied once the
+ * measurement completes, otherwise it is applied immediately. Must be called with the peripheral mutex locked. Note this does
+ * not write the LTCs' configuration.
+ * @param ltcIndex The index of the cell's LTC.
+ * @param cellIndex The index of the cell in its LTC.
+ * @param discharging True to discharge the cell, false otherwise.
+ */
+void monitorSetCellDischarging (uint16_t ltcIndex, uint16_t cellIndex, bool discharging);
+
 #endif // MONITOR_THREAD_H
\ No newline at end of file
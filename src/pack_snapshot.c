@@ -0,0 +1,57 @@
+// Header
+#include "pack_snapshot.h"
+
+// C Standard Library
+#include <string.h>
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The snapshot buffers. The active buffer is read by consumers, the other is written by the monitor thread.
+static packSnapshot_t buffers [2];
+
+/// @brief The index of the active buffer.
+static volatile uint8_t activeIndex = 0;
+
+/// @brief The sequence number of the active buffer. Written last during a publish and checked after every copy.
+static volatile uint32_t sequence = 0;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+packSnapshot_t* packSnapshotBeginWrite (void)
+{
+	return &buffers [activeIndex ^ 1];
+}
+
+void packSnapshotPublish (void)
+{
+	packSnapshot_t* buffer = &buffers [activeIndex ^ 1];
+
+	chSysLock ();
+	buffer->sequence = sequence + 1;
+	buffer->timestamp = chVTGetSystemTimeX ();
+	activeIndex ^= 1;
+	sequence = buffer->sequence;
+	chSysUnlock ();
+}
+
+void packSnapshotRead (packSnapshot_t* snapshot)
+{
+	while (true)
+	{
+		// Note the active buffer is only written after a second publish, which would also change the sequence number.
+		uint32_t sequenceStart = sequence;
+
+		// Compiler barriers prevent the copy from being moved outside of the sequence number checks.
+		__asm__ volatile ("" ::: "memory");
+		memcpy (snapshot, &buffers [activeIndex], sizeof (packSnapshot_t));
+		__asm__ volatile ("" ::: "memory");
+
+		if (sequence == sequenceStart && snapshot->sequence == sequenceStart)
+			return;
+	}
+}
+
+uint32_t packSnapshotSequence (void)
+{
+	return sequence;
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef PACK_SNAPSHOT_H
+#define PACK_SNAPSHOT_H
+
+// Pack Snapshot --------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Versioned snapshot of the accumulator's state, published by the monitor thread once per cycle. Consumers read
+//   the snapshot without taking the peripheral mutex, meaning the safety loop is never delayed by them.
+//
+//   The snapshot is double-buffered. The monitor thread fills the inactive buffer, then publishes it by swapping buffers and
+//   incrementing the sequence number. Readers copy the active buffer and retry if the sequence number changed during the copy,
+//   so a reader never observes a partially written snapshot.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	/// @brief The sequence number of the snapshot, incremented on each publish.
+	uint32_t sequence;
+
+	/// @brief The system time at which the snapshot was published.
+	systime_t timestamp;
+
+	/// @brief The voltage of each cell, indexed by LTC then by cell.
+	float cellVoltages [LTC_COUNT][LTC6811_CELL_COUNT];
+
+	/// @brief Bitmask of each LTC's undervoltage cells, bit n indicating cell n.
+	uint16_t undervoltageFaults [LTC_COUNT];
+
+	/// @brief Bitmask of each LTC's overvoltage cells, bit n indicating cell n.
+	uint16_t overvoltageFaults [LTC_COUNT];
+
+	/// @brief Bitmask of each LTC's open sense-lines, bit n indicating sense-line n.
+	uint16_t openWireFaults [LTC_COUNT];
+
+	/// @brief Bitmask of each LTC's discharging cells, bit n indicating cell n.
+	uint16_t cellsDischarging [LTC_COUNT];
+
+	/// @brief The total time each cell has discharged for, in microseconds, indexed by LTC then by cell. This excludes the time
+	/// discharging is suspended for measurements. Note this wraps around, so only the difference between snapshots is
+	/// meaningful.
+	uint32_t dischargeTimes [LTC_COUNT][LTC6811_CELL_COUNT];
+
+	/// @brief The number of cell voltage samples each cell has been reported undervoltage or overvoltage in since boot, indexed
+	/// by LTC then by cell. Saturates at the maximum word.
+	uint16_t cellFaultCounts [LTC_COUNT][LTC6811_CELL_COUNT];
+
+	/// @brief The state of each LTC, see @c ltc6811State_t . Stored as a byte, as this is mapped into the readonly EEPROM.
+	uint8_t ltcStates [LTC_COUNT];
+
+	/// @brief The die temperature of each LTC.
+	float dieTemperatures [LTC_COUNT];
+
+	/// @brief The temperature of each thermistor, indexed by LTC then by GPIO.
+	float temperatures [LTC_COUNT][LTC6811_GPIO_COUNT];
+
+	/// @brief Bitmask of each LTC's undertemperature thermistors, bit n indicating GPIO n.
+	uint8_t undertemperatureFaults [LTC_COUNT];
+
+	/// @brief Bitmask of each LTC's overtemperature thermistors, bit n indicating GPIO n.
+	uint8_t overtemperatureFaults [LTC_COUNT];
+
+	/// @brief The minimum, maximum, and average cell voltage of the pack.
+	float cellVoltageMin;
+	float cellVoltageMax;
+	float cellVoltageAverage;
+
+	/// @brief The pack-wide index (LTC index * cell count + cell index) of the minimum and maximum cell voltages.
+	uint16_t cellVoltageMinIndex;
+	uint16_t cellVoltageMaxIndex;
+
+	/// @brief The minimum, maximum, and average thermistor temperature of the pack. Invalid sensors are excluded, if no sensor
+	/// is valid, all three are NaN.
+	float temperatureMin;
+	float temperatureMax;
+	float temperatureAverage;
+
+	/// @brief The pack-wide index (LTC index * GPIO count + GPIO index) of the minimum and maximum temperatures.
+	uint16_t temperatureMinIndex;
+	uint16_t temperatureMaxIndex;
+
+	/// @brief The voltage of the entire pack, as measured by the LTCs.
+	float packVoltage;
+
+	/// @brief The current of the pack, as measured by the current sensor.
+	float packCurrent;
+
+	// Global state, see peripherals.h for details.
+	bool bmsFault;
+	bool undervoltageFault;
+	bool overvoltageFault;
+	bool undertemperatureFault;
+	bool overtemperatureFault;
+	bool senseLineFault;
+	bool isospiFault;
+	bool selfTestFault;
+	bool charging;
+	bool balancing;
+	bool shutdownLoopClosed;
+	bool prechargeComplete;
+	bool shutdownLoopBlip;
+	bool bmsFaultRelay;
+	bool imdFaultRelay;
+} packSnapshot_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Gets the inactive snapshot buffer, to be filled by the writer. Only the monitor thread may write the snapshot.
+ * @note The buffer's contents are undefined, the writer must fill every field.
+ * @return The buffer to write.
+ */
+packSnapshot_t* packSnapshotBeginWrite (void);
+
+/**
+ * @brief Publishes the buffer returned by @c packSnapshotBeginWrite , making it the active snapshot.
+ */
+void packSnapshotPublish (void);
+
+/**
+ * @brief Copies the latest published snapshot. Does not block, the copy is retried if a publish occurs during it.
+ * @param snapshot The buffer to write the snapshot into.
+ */
+void packSnapshotRead (packSnapshot_t* snapshot);
+
+/**
+ * @brief Gets the sequence number of the latest published snapshot. Can be used to check for a new snapshot without copying it.
+ * @return The sequence number, 0 if no snapshot has been published.
+ */
+uint32_t packSnapshotSequence (void);
+
+#endif // PACK_SNAPSHOT_H
\ No newline at end of file
@@ -2,7 +2,13 @@
 #include "peripherals.h"
 
 // Includes
+#include "monitor_thread.h"
 #include "peripherals/adc/stm_adc.h"
+#include "peripherals/eeprom_slots.h"
+#include "peripherals/eeprom_transaction.h"
+
+// C Standard Library
+#include <string.h>
 
 // TODO(Barach): This is pretty messy, whole lot of hard-coded values and copy-paste code.
 
@@ -30,6 +36,7 @@ bool imdFaultRelay = true;
 
 // Public
 mutex_t					peripheralMutex;
+mutex_t					eepromMutex;
 stmAdc_t				adc;
 mc24lc32_t				physicalEeprom;
 virtualEeprom_t			virtualEeprom;
@@ -39,8 +46,15 @@ thermistorPulldown_t	thermistors [LTC_COUNT][LTC6811_GPIO_COUNT];
 dhabS124_t				currentSensor;
 
 // Private
+eeprom_t				transactionEeprom;
 eeprom_t				readonlyWriteonlyEeprom;
 
+/// @brief The configurations applied by the last reconfiguration. Used to only re-initialize the peripherals whose
+/// configuration changed.
+static thermistorPulldownConfig_t	appliedThermistorConfig;
+static dhabS124Config_t				appliedCurrentSensorConfig;
+static bool							configApplied = false;
+
 // Configuration --------------------------------------------------------------------------------------------------------------
 
 /// @brief Configuration for the I2C 1 bus.
@@ -75,7 +89,7 @@ static const mc24lc32Config_t PHYSICAL_EEPROM_CONFIG =
 	.i2c			= &I2CD1,
 	.timeout		= TIME_MS2I (500),
 	.magicString	= EEPROM_MAP_STRING,
-	.dirtyHook		= peripheralsReconfigure
+	.dirtyHook		= eepromTransactionDirtyHook
 };
 
 /// @brief Configuration for the BMS's virtual EEPROM.
@@ -85,7 +99,7 @@ static const virtualEepromConfig_t VIRTUAL_EEPROM_CONFIG =
 	.entries	=
 	{
 		{
-			.eeprom	= (eeprom_t*) &physicalEeprom,
+			.eeprom	= &transactionEeprom,
 			.addr	= 0x0000,
 			.size	= 0x1000,
 		},
@@ -97,8 +111,9 @@ static const virtualEepromConfig_t VIRTUAL_EEPROM_CONFIG =
 	}
 };
 
-/// @brief Configuration for the LTC daisy chain.
-static const ltc6811Config_t DAISY_CHAIN_CONFIG =
+/// @brief Configuration for the LTC daisy chain. Note the fault count is overwritten at initialization, see
+/// @c monitorFaultCount .
+static ltc6811Config_t DAISY_CHAIN_CONFIG =
 {
 	.spiDriver				= &SPID1,
 	.spiConfig 				=
@@ -121,9 +136,9 @@ static const ltc6811Config_t DAISY_CHAIN_CONFIG =
 	.dischargeAllowed		= true,								// Allow cell discharging.
 	.dischargeTimeout		= LTC6811_DISCHARGE_TIMEOUT_30_S,	// Timeout cell discharging after 30s of no command.
 	.openWireTestIterations	= 3,								// Perform 3 pull-up / pull-down commands before measuring.
-	.faultCount				= 8,								// Maximum of 8 continuous faults allowed. At a sampling rate
-																// of 4 Hz, this is 2 seconds.
-	.cellVoltageMax			= 4.16,								// Maximum voltage for the COSMX 95B0D0HD, any higher exceeds a
+	.faultCount				= 8,								// Maximum of 8 continuous faults allowed. Scaled to the cell
+																// voltage sampling rate at initialization.
+	.cellVoltageMax			= CELL_VOLTAGE_MAX,					// Maximum voltage for the COSMX 95B0D0HD, any higher exceeds a
 																// pack voltage of 600V and is therefore illegal.
 	.cellVoltageMin			= 3,								// Minimum voltage for the COSMX 95B0D0HD, any lower is below
 																// the acceptable voltage range.
@@ -248,11 +263,47 @@ void onShutdownLoopOpen (void* arg)
 	}
 }
 
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Re-initializes the peripherals whose configuration differs from the working memory map. The peripheral mutex must be
+ * held, so the map can't change between the comparison and the re-initialization.
+ */
+static void reconfigure (void)
+{
+	// Determine which peripherals' configurations changed. Other fields of the EEPROM map are read directly by their users, so
+	// don't require any re-initialization.
+	bool thermistorsChanged = !configApplied || memcmp (&appliedThermistorConfig, &physicalEepromMap->thermistorConfig,
+		sizeof (thermistorPulldownConfig_t)) != 0;
+	bool currentSensorChanged = !configApplied || memcmp (&appliedCurrentSensorConfig,
+		&physicalEepromMap->currentSensorConfig, sizeof (dhabS124Config_t)) != 0;
+
+	// Thermistor initialization
+	if (thermistorsChanged)
+	{
+		for (uint16_t deviceIndex = 0; deviceIndex < LTC_COUNT; ++deviceIndex)
+			for (uint16_t gpioIndex = 0; gpioIndex < LTC6811_GPIO_COUNT; ++gpioIndex)
+				thermistorPulldownInit (&thermistors [deviceIndex][gpioIndex], &physicalEepromMap->thermistorConfig);
+
+		appliedThermistorConfig = physicalEepromMap->thermistorConfig;
+	}
+
+	// Current sensor initialization
+	if (currentSensorChanged)
+	{
+		dhabS124Init (&currentSensor, &physicalEepromMap->currentSensorConfig);
+		appliedCurrentSensorConfig = physicalEepromMap->currentSensorConfig;
+	}
+
+	configApplied = true;
+}
+
 // Functions ------------------------------------------------------------------------------------------------------------------
 
 bool peripheralsInit (void)
 {
 	chMtxObjectInit (&peripheralMutex);
+	chMtxObjectInit (&eepromMutex);
 
 	// ADC 1 initialization
 	if (!stmAdcInit (&adc, &ADC_CONFIG))
@@ -263,20 +314,34 @@ bool peripheralsInit (void)
 		return false;
 
 	// Physical EEPROM initialization (only exit early if a failure occurred).
-	if (!mc24lc32Init (&physicalEeprom, &PHYSICAL_EEPROM_CONFIG) && physicalEeprom.state == MC24LC32_STATE_FAILED)
+	bool legacyValid = mc24lc32Init (&physicalEeprom, &PHYSICAL_EEPROM_CONFIG);
+	if (!legacyValid && physicalEeprom.state == MC24LC32_STATE_FAILED)
 		return false;
 
+	// Load the memory map from the config slots. If no valid map could be loaded, everything past the magic string is cleared,
+	// disabling charging and balancing until the map is programmed.
+	if (!eepromSlotsLoad (legacyValid))
+		memset ((uint8_t*) physicalEepromMap + sizeof (physicalEepromMap->pad0), 0,
+			sizeof (eepromMap_t) - sizeof (physicalEepromMap->pad0));
+
+	// Transaction EEPROM initialization
+	eepromInit (&transactionEeprom, eepromTransactionWrite, eepromTransactionRead);
+
 	// Readonly / Writeonly EEPROM initialization
 	eepromInit (&readonlyWriteonlyEeprom, eepromWriteonlyWrite, eepromReadonlyRead);
 
-	// Virtual EEPROM initialization
+	// Virtual EEPROM initialization. An overlap in the readonly EEPROM's layout is a build error, so is treated as fatal.
 	virtualEepromInit (&virtualEeprom, &VIRTUAL_EEPROM_CONFIG);
+	if (!eepromReadonlyValidate ())
+		return false;
 
 	// Reconfigurable peripheral initializations. Note this must occur before the LTC initialization as the LTCs are dependent
 	// on the thermistor peripherals.
 	peripheralsReconfigure (NULL);
 
-	// LTC daisy chain initialization
+	// LTC daisy chain initialization. The fault count is based on the configured sampling rate, so changes to it only apply
+	// after a restart.
+	DAISY_CHAIN_CONFIG.faultCount = monitorFaultCount ();
 	ltc6811Init (DAISY_CHAIN, LTC_COUNT, &DAISY_CHAIN_CONFIG);
 	ltcBottom = DAISY_CHAIN [0];
 
@@ -292,14 +357,14 @@ void peripheralsReconfigure (void* caller)
 	(void) caller;
 
 	chMtxLock (&peripheralMutex);
+	reconfigure ();
+	chMtxUnlock (&peripheralMutex);
+}
 
-	// Thermistor initialization
-	for (uint16_t deviceIndex = 0; deviceIndex < LTC_COUNT; ++deviceIndex)
-		for (uint16_t gpioIndex = 0; gpioIndex < LTC6811_GPIO_COUNT; ++gpioIndex)
-			thermistorPulldownInit (&thermistors [deviceIndex][gpioIndex], &physicalEepromMap->thermistorConfig);
-
-	// Current sensor initialization
-	dhabS124Init (&currentSensor, &physicalEepromMap->currentSensorConfig);
-
+void peripheralsApplyMap (const eepromMap_t* map)
+{
+	chMtxLock (&peripheralMutex);
+	memcpy (physicalEepromMap, map, sizeof (eepromMap_t));
+	reconfigure ();
 	chMtxUnlock (&peripheralMutex);
 }
\ No newline at end of file
@@ -34,6 +34,10 @@
 /// @brief The number of temperature sensors in the accumulator.
 #define TEMP_COUNT (LTC_COUNT * LTC6811_GPIO_COUNT)
 
+/// @brief The overvoltage limit of the cells, in volts. Cells above this are faulted by the LTCs, so the charge must be
+/// regulated below it.
+#define CELL_VOLTAGE_MAX 4.16f
+
 // Global State ---------------------------------------------------------------------------------------------------------------
 
 /// @brief The voltage of the entire pack, as measured by the LTCs.
@@ -91,6 +95,10 @@ extern bool imdFaultRelay;
 /// @brief Mutex guarding access to the global peripherals.
 extern mutex_t peripheralMutex;
 
+/// @brief Mutex serializing writes to the physical EEPROM (the config slots, the working memory map, and the balancing
+/// ledger). If both are needed, this must be taken before the peripheral mutex.
+extern mutex_t eepromMutex;
+
 /// @brief The STM's on-board ADC.
 extern stmAdc_t adc;
 
@@ -125,9 +133,17 @@ extern dhabS124_t currentSensor;
 bool peripheralsInit (void);
 
 /**
- * @brief Re-initializes the BMS's peripherals after a change has been made to the on-board EEPROM.
+ * @brief Re-initializes the BMS's peripherals after a change has been made to the on-board EEPROM. Only the peripherals whose
+ * configuration changed are re-initialized. The change is determined while holding the peripheral mutex.
  * @param caller Ignored. Used to make function signature compatible with EEPROM dirty hook.
  */
 void peripheralsReconfigure (void* caller);
 
+/**
+ * @brief Copies a memory map into the working memory map and re-initializes the peripherals whose configuration changed, all
+ * while holding the peripheral mutex. The monitor thread only ever sees the previous or the new map, never a mix of both.
+ * @param map The memory map to apply. Should already be validated and stored.
+ */
+void peripheralsApplyMap (const eepromMap_t* map);
+
 #endif // PERIPHERALS_H
\ No newline at end of file
@@ -3,51 +3,228 @@
 
 // Includes
 #include "peripherals.h"
+#include "pack_snapshot.h"
+#include "peripherals/eeprom_transaction.h"
+#include "profiler.h"
+#include "balancing.h"
+#include "charging.h"
+#include "monitor_thread.h"
+#include "can/transmit_thread.h"
 #include "watchdog.h"
 
 // C Standard Library
+#include <math.h>
 #include <string.h>
 
-// Constants ------------------------------------------------------------------------------------------------------------------
+// Readonly Map ---------------------------------------------------------------------------------------------------------------
 
-#define READONLY_COUNT (sizeof (READONLY_ADDRS) / sizeof (READONLY_ADDRS [0]))
-static const uint16_t READONLY_ADDRS [] =
+// The readonly EEPROM is a live map of the BMS's state. Pack data is read from a copy of the pack snapshot, refreshed whenever
+// a new snapshot has been published, so a multi-field read is consistent. Addresses are fixed so tools don't depend on the
+// snapshot's layout, note the spacing of the snapshot entries assumes at most 12 LTCs. Unmapped addresses within a read are
+// read as 0.
+
+typedef struct
 {
-	0x0000,
-	0x0002
-};
+	uint16_t addr;
+	uint16_t size;
+	const void* data;
+} readonlyEntry_t;
+
+/// @brief Copy of the pack snapshot backing the pack data entries. Guarded by @c readonlyMutex .
+static packSnapshot_t readonlySnapshot;
+
+/// @brief Mutex guarding reads of the readonly EEPROM, as it may be read from multiple threads.
+static MUTEX_DECL (readonlyMutex);
 
-static const void* READONLY_DATA [READONLY_COUNT] =
+#define READONLY_ENTRY(addr, object) { (addr), sizeof (object), &(object) }
+
+/// @brief The entries of the readonly EEPROM. Note this must be sorted by address, with no overlapping entries.
+static const readonlyEntry_t READONLY_ENTRIES [] =
 {
-	&currentSensor.channel1.sample,
-	&currentSensor.channel2.sample,
+	READONLY_ENTRY (0x0000, currentSensor.channel1.sample),
+	READONLY_ENTRY (0x0002, currentSensor.channel2.sample),
+	READONLY_ENTRY (0x0004, profilerOverrunCount),
+	READONLY_ENTRY (0x0008, transmitDropCount),
+	READONLY_ENTRY (0x000C, profilerBootTimes),
+	READONLY_ENTRY (0x0100, profilerStats),
+	READONLY_ENTRY (0x0400, readonlySnapshot.sequence),
+	READONLY_ENTRY (0x0404, readonlySnapshot.timestamp),
+	READONLY_ENTRY (0x0410, readonlySnapshot.packVoltage),
+	READONLY_ENTRY (0x0414, readonlySnapshot.packCurrent),
+	READONLY_ENTRY (0x0418, readonlySnapshot.cellVoltageMin),
+	READONLY_ENTRY (0x041C, readonlySnapshot.cellVoltageMax),
+	READONLY_ENTRY (0x0420, readonlySnapshot.cellVoltageAverage),
+	READONLY_ENTRY (0x0424, readonlySnapshot.cellVoltageMinIndex),
+	READONLY_ENTRY (0x0426, readonlySnapshot.cellVoltageMaxIndex),
+	READONLY_ENTRY (0x0428, readonlySnapshot.temperatureMin),
+	READONLY_ENTRY (0x042C, readonlySnapshot.temperatureMax),
+	READONLY_ENTRY (0x0430, readonlySnapshot.temperatureAverage),
+	READONLY_ENTRY (0x0434, readonlySnapshot.temperatureMinIndex),
+	READONLY_ENTRY (0x0436, readonlySnapshot.temperatureMaxIndex),
+	READONLY_ENTRY (0x0500, readonlySnapshot.cellVoltages),
+	READONLY_ENTRY (0x0800, readonlySnapshot.temperatures),
+	READONLY_ENTRY (0x0900, readonlySnapshot.dieTemperatures),
+	READONLY_ENTRY (0x0940, readonlySnapshot.undervoltageFaults),
+	READONLY_ENTRY (0x0960, readonlySnapshot.overvoltageFaults),
+	READONLY_ENTRY (0x0980, readonlySnapshot.openWireFaults),
+	READONLY_ENTRY (0x09A0, readonlySnapshot.cellsDischarging),
+	READONLY_ENTRY (0x09C0, readonlySnapshot.undertemperatureFaults),
+	READONLY_ENTRY (0x09D0, readonlySnapshot.overtemperatureFaults),
+	READONLY_ENTRY (0x09E0, readonlySnapshot.ltcStates),
+	READONLY_ENTRY (0x0A00, balancingAllowances),
+	READONLY_ENTRY (0x0A30, chargingState),
+	READONLY_ENTRY (0x0A34, chargingCurrentRequest),
+	READONLY_ENTRY (0x0A40, balancingLedger.budgets),
+	READONLY_ENTRY (0x0C80, balancingLedger.removed),
+	READONLY_ENTRY (0x0F00, chargingCurrentAllowed),
+	READONLY_ENTRY (0x0F04, chargingTimeToFull),
+	READONLY_ENTRY (0x0F08, chargingEnergyToFull)
 };
 
-static const uint16_t READONLY_SIZES [READONLY_COUNT] =
+#define READONLY_COUNT (sizeof (READONLY_ENTRIES) / sizeof (READONLY_ENTRIES [0]))
+
+/// @brief The size of the readonly EEPROM's address space.
+#define READONLY_SIZE 0x1000
+
+/**
+ * @brief Finds the first entry ending after an address.
+ * @param addr The address to search for.
+ * @return The index of the entry, @c READONLY_COUNT if there is none.
+ */
+static uint16_t readonlyFind (uint16_t addr)
 {
-	sizeof (uint16_t),
-	sizeof (uint16_t)
-};
+	// Binary search for the first entry whose end is past the address.
+	uint16_t low = 0;
+	uint16_t high = READONLY_COUNT;
+	while (low < high)
+	{
+		uint16_t middle = (low + high) / 2;
+		if (READONLY_ENTRIES [middle].addr + READONLY_ENTRIES [middle].size <= addr)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
-bool eepromReadonlyRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+bool eepromMapValidate (const eepromMap_t* map)
 {
-	(void) object;
+	// Limits and thresholds must be real, non-negative values. Note the negated comparison also catches NaN.
+	const float limits [] =
+	{
+		map->chargingVoltageLimit,
+		map->chargingCurrentLimit,
+		map->chargingPowerLimit,
+		map->chargingThreshold,
+		map->balancingThreshold,
+		map->cellVoltageDeadband,
+		map->temperatureDeadband,
+		map->balancingTemperatureMargin,
+		map->balancingTemperatureGain,
+		map->cellCapacity,
+		map->chargingCellVoltageTarget,
+		map->chargingProportionalGain,
+		map->chargingIntegralGain
+	};
 
-	for (uint16_t index = 0; index < READONLY_COUNT; ++index)
+	for (uint16_t index = 0; index < sizeof (limits) / sizeof (limits [0]); ++index)
+		if (!(limits [index] >= 0.0f) || isinf (limits [index]))
+			return false;
+
+	// The LTC temperature limit may be negative, but must be real.
+	if (!isfinite (map->ltcTemperatureMax))
+		return false;
+
+	// The charge must be regulated below the overvoltage limit, otherwise the cells fault before the charge completes.
+	if (!(map->chargingCellVoltageTarget < CELL_VOLTAGE_MAX))
+		return false;
+
+	// The discharge resistance is divided by, so must be positive.
+	if (!(map->balancingResistance > 0.0f) || isinf (map->balancingResistance))
+		return false;
+
+	// The OCV curve must be real and non-decreasing, so it can be inverted.
+	for (uint16_t index = 0; index < EEPROM_OCV_POINT_COUNT; ++index)
 	{
-		if (addr != READONLY_ADDRS [index])
-			continue;
+		if (!isfinite (map->ocvVoltages [index]))
+			return false;
 
-		if (dataCount != READONLY_SIZES [index])
+		if (index != 0 && map->ocvVoltages [index] < map->ocvVoltages [index - 1])
 			return false;
+	}
 
-		memcpy (data, READONLY_DATA [index], dataCount);
-		return true;
+	// The derating curve's temperatures must be real and non-decreasing, its factors must be fractions.
+	for (uint16_t index = 0; index < EEPROM_DERATING_POINT_COUNT; ++index)
+	{
+		if (!isfinite (map->deratingTemperatures [index]))
+			return false;
+
+		if (index != 0 && map->deratingTemperatures [index] < map->deratingTemperatures [index - 1])
+			return false;
+
+		if (!(map->deratingFactors [index] >= 0.0f && map->deratingFactors [index] <= 1.0f))
+			return false;
 	}
 
-	return false;
+	return true;
+}
+
+bool eepromReadonlyValidate (void)
+{
+	for (uint16_t index = 0; index < READONLY_COUNT; ++index)
+	{
+		uint16_t end = index < READONLY_COUNT - 1 ? READONLY_ENTRIES [index + 1].addr : READONLY_SIZE;
+		if (READONLY_ENTRIES [index].addr + READONLY_ENTRIES [index].size > end)
+			return false;
+	}
+
+	return true;
+}
+
+bool eepromReadonlyRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (addr + dataCount > READONLY_SIZE)
+		return false;
+
+	chMtxLock (&readonlyMutex);
+
+	if (packSnapshotSequence () != readonlySnapshot.sequence)
+		packSnapshotRead (&readonlySnapshot);
+
+	// Reads may span multiple entries, copy the overlap with each.
+	uint8_t* buffer = data;
+	uint16_t end = addr + dataCount;
+	uint16_t index = readonlyFind (addr);
+	while (addr < end)
+	{
+		uint16_t entryAddr = index < READONLY_COUNT ? READONLY_ENTRIES [index].addr : end;
+		uint16_t count;
+		if (addr < entryAddr)
+		{
+			// Gap before the next entry, or after the last one.
+			count = (entryAddr < end ? entryAddr : end) - addr;
+			memset (buffer, 0, count);
+		}
+		else
+		{
+			const readonlyEntry_t* entry = &READONLY_ENTRIES [index];
+			uint16_t entryEnd = entry->addr + entry->size;
+			count = (entryEnd < end ? entryEnd : end) - addr;
+			memcpy (buffer, (const uint8_t*) entry->data + (addr - entry->addr), count);
+			++index;
+		}
+
+		buffer += count;
+		addr += count;
+	}
+
+	chMtxUnlock (&readonlyMutex);
+	return true;
 }
 
 bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
@@ -72,11 +249,13 @@ bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16
 
 		ltcIndex = *((uint8_t*) data) / LTC6811_CELL_COUNT;
 		cellIndex = *((uint8_t*) data) % LTC6811_CELL_COUNT;
-		if (ltcIndex > LTC_COUNT)
+		if (ltcIndex >= LTC_COUNT)
 			return false;
 
-		ltcs [ltcIndex].cellsDischarging [cellIndex] = false;
+		chMtxLock (&peripheralMutex);
+		monitorSetCellDischarging (ltcIndex, cellIndex, false);
 		ltc6811WriteConfig (ltcBottom);
+		chMtxUnlock (&peripheralMutex);
 		return true;
 
 	case 0x0003: // Cell discharge enable command.
@@ -85,11 +264,28 @@ bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16
 
 		ltcIndex = *((uint8_t*) data) / LTC6811_CELL_COUNT;
 		cellIndex = *((uint8_t*) data) % LTC6811_CELL_COUNT;
-		if (ltcIndex > LTC_COUNT)
+		if (ltcIndex >= LTC_COUNT)
 			return false;
 
-		ltcs [ltcIndex].cellsDischarging [cellIndex] = true;
+		chMtxLock (&peripheralMutex);
+		monitorSetCellDischarging (ltcIndex, cellIndex, true);
 		ltc6811WriteConfig (ltcBottom);
+		chMtxUnlock (&peripheralMutex);
+		return true;
+
+	case 0x0004: // Profiler reset command.
+		profilerReset ();
+		return true;
+
+	case 0x0005: // Config transaction begin command.
+		eepromTransactionBegin ();
+		return true;
+
+	case 0x0006: // Config transaction commit command.
+		return eepromTransactionCommit ();
+
+	case 0x0007: // Config transaction abort command.
+		eepromTransactionAbort ();
 		return true;
 	}
 
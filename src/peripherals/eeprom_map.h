@@ -16,9 +16,20 @@
 
 // Constants ------------------------------------------------------------------------------------------------------------------
 
-/// @brief The magic string of the EEPROM. Update this value every time the memory map changes to force manual re-programming.
+/// @brief The magic string of the legacy (unslotted) EEPROM map. Only used to carry a legacy map forward into the config
+/// slots, the slots themselves are validated by CRC. See peripherals/eeprom_slots.h for details.
 #define EEPROM_MAP_STRING "BMS_2025_06_01"
 
+/// @brief The version of the memory map's layout. Increment this value every time the memory map changes, and add the previous
+/// layout to the migration table in peripherals/eeprom_slots.c.
+#define EEPROM_MAP_VERSION 6
+
+/// @brief The number of points in the cell's open-circuit voltage curve, spaced evenly from 0% to 100% state of charge.
+#define EEPROM_OCV_POINT_COUNT 11
+
+/// @brief The number of points in the charging current's temperature derating curve.
+#define EEPROM_DERATING_POINT_COUNT 6
+
 // Datatypes ------------------------------------------------------------------------------------------------------------------
 
 typedef struct
@@ -29,15 +40,50 @@ typedef struct
 	float chargingVoltageLimit;						// 0x0050
 	float chargingCurrentLimit;						// 0x0054
 	float chargingPowerLimit;						// 0x0058
-	float chargingThreshold;						// 0x005C
+	float chargingThreshold;						// 0x005C Current the charge is terminated at, in amps.
 	bool balancingEnabled;							// 0x0060
 	bool chargingEnabled;							// 0x0061
 	float balancingThreshold;						// 0x0064
 	float ltcTemperatureMax;						// 0x0068
+	uint16_t cellSamplePeriod;						// 0x006C Period of the cell voltage loop, in milliseconds.
+	uint16_t temperatureSamplePeriod;				// 0x006E Period of the temperature loop, in milliseconds.
+	uint16_t openWireTestPeriod;					// 0x0070 Period of the open-wire test, in milliseconds.
+	uint16_t faultTime;								// 0x0072 Time a fault must be present for, in milliseconds.
+	float cellVoltageDeadband;						// 0x0074 Change required to re-send a cell voltage message, in volts.
+	float temperatureDeadband;						// 0x0078 Change required to re-send a temperature message, in celsius.
+	uint16_t canRefreshPeriod;						// 0x007C Max period between change-driven messages, in milliseconds.
+	bool canDeadbandEnabled;						// 0x007E Enables change-driven transmission of the bulk messages.
+	uint16_t canBulkPeriod;							// 0x0080 Period of the bulk CAN messages, in milliseconds.
+	float balancingTemperatureMargin;				// 0x0084 Die temperature balancing regulates to, below ltcTemperatureMax.
+	float balancingTemperatureGain;					// 0x0088 Gain of the balancing controller, in cells per celsius-second.
+	uint16_t balancingRelaxationTime;				// 0x008C Time cells relax for after discharging, in milliseconds.
+	float ocvVoltages [EEPROM_OCV_POINT_COUNT];		// 0x0090 Open-circuit voltage of a cell at 0%, 10%, ..., 100% SOC.
+	float cellCapacity;								// 0x00BC Capacity of each cell, in amp-hours.
+	float balancingResistance;						// 0x00C0 Resistance of each cell's discharge path, in ohms.
+	float chargingCellVoltageTarget;				// 0x00C4 Cell voltage the charge is regulated to, below CELL_VOLTAGE_MAX.
+	float chargingProportionalGain;					// 0x00C8 Proportional gain of the CV loop, in amps per volt.
+	float chargingIntegralGain;						// 0x00CC Integral gain of the CV loop, in amps per volt-second.
+	uint16_t chargingCommandPeriod;					// 0x00D0 Period of the charger commands, in milliseconds.
+	float deratingTemperatures [EEPROM_DERATING_POINT_COUNT];	// 0x00D4 Temperatures of the derating curve, in celsius.
+	float deratingFactors [EEPROM_DERATING_POINT_COUNT];		// 0x00EC Fraction of the current limit allowed at each.
 } eepromMap_t;
 
 // Functions ------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Validates the contents of a memory map before it is written to the EEPROM.
+ * @param map The memory map to validate.
+ * @return True if the map is valid, false otherwise.
+ */
+bool eepromMapValidate (const eepromMap_t* map);
+
+/**
+ * @brief Checks the layout of the readonly EEPROM, that is, that its entries are sorted by address and that each entry ends
+ * before the next one starts. The entries are sized by their objects, so this catches an object outgrowing its address range.
+ * @return True if the layout is valid, false otherwise.
+ */
+bool eepromReadonlyValidate (void);
+
 bool eepromReadonlyRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
 
 bool eepromWriteonlyWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
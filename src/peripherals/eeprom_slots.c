@@ -0,0 +1,440 @@
+// Header
+#include "eeprom_slots.h"
+
+// Includes
+#include "peripherals.h"
+
+// C Standard Library
+#include <stddef.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of a write page of the physical EEPROM. Writes within a page are performed in a single burst.
+#define EEPROM_PAGE_SIZE	32
+
+/// @brief The layout of the legacy memory map, stored at the start of the physical EEPROM. This is the last layout deployed
+/// before the config slots, identified by the "BMS_2025_06_01" magic string.
+#define LEGACY_VERSION		0
+#define LEGACY_SIZE			0x006C
+
+/// @brief Values of the working header's state.
+#define WORKING_STATE_CLEAN	0xFFFF
+#define WORKING_STATE_DIRTY	0x5AD1
+
+/// @brief Defaults of the loop periods and CAN transmission config, for layouts predating them.
+#define CELL_SAMPLE_PERIOD_DEFAULT				250
+#define TEMPERATURE_SAMPLE_PERIOD_DEFAULT		250
+#define OPEN_WIRE_TEST_PERIOD_DEFAULT			250
+#define FAULT_TIME_DEFAULT						2000
+#define CELL_VOLTAGE_DEADBAND_DEFAULT			0.005f
+#define TEMPERATURE_DEADBAND_DEFAULT			0.5f
+#define CAN_REFRESH_PERIOD_DEFAULT				1000
+#define CAN_BULK_PERIOD_DEFAULT					250
+
+/// @brief Defaults of the balancing config, for layouts predating it.
+#define BALANCING_TEMPERATURE_MARGIN_DEFAULT	5.0f
+#define BALANCING_TEMPERATURE_GAIN_DEFAULT		0.05f
+#define BALANCING_RELAXATION_TIME_DEFAULT		10
+#define CELL_CAPACITY_DEFAULT					4.5f
+#define BALANCING_RESISTANCE_DEFAULT			33.0f
+
+/// @brief Defaults of the charge controller's config, for layouts predating it. Note the target leaves a margin below the
+/// overvoltage limit (see @c CELL_VOLTAGE_MAX ), which the integral gain must be high enough to regulate within, as the
+/// cells overshoot the target while the integral winds down.
+#define CHARGING_CELL_VOLTAGE_TARGET_DEFAULT	4.14f
+#define CHARGING_PROPORTIONAL_GAIN_DEFAULT		50.0f
+#define CHARGING_INTEGRAL_GAIN_DEFAULT			20.0f
+#define CHARGING_COMMAND_PERIOD_DEFAULT			500
+
+/// @brief Default derating curve of the charging current, for layouts predating it. Charging is stopped below -10 C and
+/// above 60 C, with full current allowed from 10 C to 45 C.
+static const float DERATING_TEMPERATURES_DEFAULT [EEPROM_DERATING_POINT_COUNT] =
+{
+	-10.0f, 0.0f, 10.0f, 45.0f, 55.0f, 60.0f
+};
+static const float DERATING_FACTORS_DEFAULT [EEPROM_DERATING_POINT_COUNT] =
+{
+	0.0f, 0.1f, 1.0f, 1.0f, 0.25f, 0.0f
+};
+
+/// @brief Default OCV curve, for layouts predating it. This is a typical curve of an NMC cell.
+static const float OCV_VOLTAGES_DEFAULT [EEPROM_OCV_POINT_COUNT] =
+{
+	3.00f, 3.45f, 3.55f, 3.62f, 3.68f, 3.75f, 3.85f, 3.95f, 4.03f, 4.10f, 4.20f
+};
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint32_t crc;
+	uint32_t sequence;
+	uint16_t version;
+	uint16_t length;
+	uint8_t map [EEPROM_SLOT_SIZE - 12];
+} eepromSlot_t;
+
+typedef struct
+{
+	/// @brief CRC-32 of the working region, up to the length of the working memory map.
+	uint32_t crc;
+	/// @brief Indicates whether the working memory map has uncommitted writes, see @c WORKING_STATE_DIRTY .
+	uint16_t state;
+	/// @brief The version of the working memory map's layout.
+	uint16_t version;
+	/// @brief The length of the working memory map, in bytes.
+	uint16_t length;
+} workingHeader_t;
+
+typedef struct
+{
+	/// @brief The version of the layout.
+	uint16_t version;
+	/// @brief Carries a map of this version forward into the current layout. If @c NULL , the layout only differs from the
+	/// current layout by appended fields, so the common prefix is copied and the appended fields are left as 0.
+	void (*migrate) (const uint8_t* data, uint16_t length, eepromMap_t* map);
+} eepromMigration_t;
+
+// Migration Table ------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Migrates a version 5 memory map, which predates the charging current's derating curve.
+ */
+static void migrateVersion5 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	memcpy (map, data, length < sizeof (eepromMap_t) ? length : sizeof (eepromMap_t));
+	memcpy (map->deratingTemperatures, DERATING_TEMPERATURES_DEFAULT, sizeof (DERATING_TEMPERATURES_DEFAULT));
+	memcpy (map->deratingFactors, DERATING_FACTORS_DEFAULT, sizeof (DERATING_FACTORS_DEFAULT));
+}
+
+/**
+ * @brief Migrates a version 4 memory map, which predates the charge controller's config.
+ */
+static void migrateVersion4 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	migrateVersion5 (data, length, map);
+	map->chargingCellVoltageTarget	= CHARGING_CELL_VOLTAGE_TARGET_DEFAULT;
+	map->chargingProportionalGain	= CHARGING_PROPORTIONAL_GAIN_DEFAULT;
+	map->chargingIntegralGain		= CHARGING_INTEGRAL_GAIN_DEFAULT;
+	map->chargingCommandPeriod		= CHARGING_COMMAND_PERIOD_DEFAULT;
+}
+
+/**
+ * @brief Migrates a version 3 memory map, which predates the cell model (OCV curve, capacity, and discharge resistance).
+ */
+static void migrateVersion3 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	migrateVersion4 (data, length, map);
+	memcpy (map->ocvVoltages, OCV_VOLTAGES_DEFAULT, sizeof (OCV_VOLTAGES_DEFAULT));
+	map->cellCapacity			= CELL_CAPACITY_DEFAULT;
+	map->balancingResistance	= BALANCING_RESISTANCE_DEFAULT;
+}
+
+/**
+ * @brief Migrates a version 2 memory map, which predates the balancing relaxation time.
+ */
+static void migrateVersion2 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	migrateVersion3 (data, length, map);
+	map->balancingRelaxationTime = BALANCING_RELAXATION_TIME_DEFAULT;
+}
+
+/**
+ * @brief Migrates a version 1 memory map, which predates the balancing controller's config.
+ */
+static void migrateVersion1 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	migrateVersion2 (data, length, map);
+	map->balancingTemperatureMargin	= BALANCING_TEMPERATURE_MARGIN_DEFAULT;
+	map->balancingTemperatureGain	= BALANCING_TEMPERATURE_GAIN_DEFAULT;
+}
+
+/**
+ * @brief Migrates a version 0 (legacy) memory map, which predates the configurable loop periods and CAN transmission.
+ */
+static void migrateVersion0 (const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	migrateVersion1 (data, length, map);
+	map->cellSamplePeriod			= CELL_SAMPLE_PERIOD_DEFAULT;
+	map->temperatureSamplePeriod	= TEMPERATURE_SAMPLE_PERIOD_DEFAULT;
+	map->openWireTestPeriod			= OPEN_WIRE_TEST_PERIOD_DEFAULT;
+	map->faultTime					= FAULT_TIME_DEFAULT;
+	map->cellVoltageDeadband		= CELL_VOLTAGE_DEADBAND_DEFAULT;
+	map->temperatureDeadband		= TEMPERATURE_DEADBAND_DEFAULT;
+	map->canRefreshPeriod			= CAN_REFRESH_PERIOD_DEFAULT;
+	map->canDeadbandEnabled			= false;
+	map->canBulkPeriod				= CAN_BULK_PERIOD_DEFAULT;
+}
+
+/// @brief The layouts that can be loaded. When @c EEPROM_MAP_VERSION is incremented, the previous layout must be added here.
+static const eepromMigration_t MIGRATIONS [] =
+{
+	{ .version = 0,						.migrate = migrateVersion0 },
+	{ .version = 1,						.migrate = migrateVersion1 },
+	{ .version = 2,						.migrate = migrateVersion2 },
+	{ .version = 3,						.migrate = migrateVersion3 },
+	{ .version = 4,						.migrate = migrateVersion4 },
+	{ .version = 5,						.migrate = migrateVersion5 },
+	{ .version = EEPROM_MAP_VERSION,	.migrate = NULL }
+};
+
+#define MIGRATION_COUNT (sizeof (MIGRATIONS) / sizeof (MIGRATIONS [0]))
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The slot holding the working memory map, the other slot is written next.
+static uint16_t activeSlotAddr = EEPROM_SLOT_B_ADDR;
+
+/// @brief The sequence number of the active slot.
+static uint32_t activeSequence = 0;
+
+/// @brief Indicates a record (a slot, the working header, or a record written by @c eepromSlotsWritePages ) is being written.
+/// Guarded by @c eepromMutex .
+static bool storing = false;
+
+/// @brief Buffer used to build a slot before it is written.
+static eepromSlot_t slotBuffer;
+
+/// @brief Indicates the working memory map has writes that have not been stored into a slot.
+static bool dirty = false;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Gets the number of bytes covered by a slot's CRC.
+ * @param slot The slot.
+ * @return The number of bytes, starting from the sequence number.
+ */
+static uint16_t crcLength (const eepromSlot_t* slot)
+{
+	return offsetof (eepromSlot_t, map) - offsetof (eepromSlot_t, sequence) + slot->length;
+}
+
+/**
+ * @brief Finds the migration for a version of the memory map.
+ * @param version The version to find.
+ * @return The migration, @c NULL if the version is unknown.
+ */
+static const eepromMigration_t* findMigration (uint16_t version)
+{
+	for (uint16_t index = 0; index < MIGRATION_COUNT; ++index)
+		if (MIGRATIONS [index].version == version)
+			return &MIGRATIONS [index];
+
+	return NULL;
+}
+
+/**
+ * @brief Migrates a memory map into the current layout.
+ * @param version The version of the memory map's layout. Must be in the migration table.
+ * @param data The memory map to migrate. May not overlap @c map .
+ * @param length The length of the memory map, in bytes.
+ * @param map Written to contain the migrated memory map.
+ */
+static void migrate (uint16_t version, const uint8_t* data, uint16_t length, eepromMap_t* map)
+{
+	const eepromMigration_t* migration = findMigration (version);
+	memset (map, 0, sizeof (eepromMap_t));
+	if (migration->migrate != NULL)
+		migration->migrate (data, length, map);
+	else
+		memcpy (map, data, length < sizeof (eepromMap_t) ? length : sizeof (eepromMap_t));
+}
+
+/**
+ * @brief Checks whether a slot is valid.
+ * @param slot The slot to check.
+ * @return True if the slot's length and version are supported and its CRC matches, false otherwise.
+ */
+static bool slotValid (const eepromSlot_t* slot)
+{
+	if (slot->length > sizeof (slot->map) || findMigration (slot->version) == NULL)
+		return false;
+
+	return eepromSlotsCrc32 ((const uint8_t*) &slot->sequence, crcLength (slot)) == slot->crc;
+}
+
+/**
+ * @brief Writes the working header, including the CRC of the working region as it currently is.
+ * @param state The state to write, either @c WORKING_STATE_CLEAN or @c WORKING_STATE_DIRTY .
+ * @return True if successful, false otherwise.
+ */
+static bool writeWorkingHeader (uint16_t state)
+{
+	workingHeader_t header =
+	{
+		.crc		= eepromSlotsCrc32 (physicalEeprom.cache, sizeof (eepromMap_t)),
+		.state		= state,
+		.version	= EEPROM_MAP_VERSION,
+		.length		= sizeof (eepromMap_t)
+	};
+
+	storing = true;
+	bool result = eepromWrite ((eeprom_t*) &physicalEeprom, EEPROM_WORKING_HEADER_ADDR, &header, sizeof (header));
+	storing = false;
+	return result;
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool eepromSlotsLoad (bool legacyValid)
+{
+	const eepromSlot_t* slotA = (const eepromSlot_t*) &physicalEeprom.cache [EEPROM_SLOT_A_ADDR];
+	const eepromSlot_t* slotB = (const eepromSlot_t*) &physicalEeprom.cache [EEPROM_SLOT_B_ADDR];
+	const workingHeader_t* header = (const workingHeader_t*) &physicalEeprom.cache [EEPROM_WORKING_HEADER_ADDR];
+	bool slotAValid = slotValid (slotA);
+	bool slotBValid = slotValid (slotB);
+	bool workingDirty = header->state == WORKING_STATE_DIRTY && findMigration (header->version) != NULL
+		&& header->length <= sizeof (slotBuffer.map) && eepromSlotsCrc32 (physicalEeprom.cache, header->length) == header->crc;
+
+	// Pick the newest valid slot. Note the sequence comparison handles wrap-around.
+	const eepromSlot_t* slot;
+	if (slotAValid && (!slotBValid || (int32_t) (slotA->sequence - slotB->sequence) > 0))
+	{
+		slot = slotA;
+		activeSlotAddr = EEPROM_SLOT_A_ADDR;
+	}
+	else if (slotBValid)
+	{
+		slot = slotB;
+		activeSlotAddr = EEPROM_SLOT_B_ADDR;
+	}
+	else
+	{
+		slot = NULL;
+	}
+
+	if (slot != NULL)
+		activeSequence = slot->sequence;
+
+	// Uncommitted writes were made after the newest slot was stored, so the working memory map takes precedence. Note it is
+	// copied out before being migrated. If its layout is outdated, it is not considered dirty, so the working region is
+	// re-written in the current layout before the next direct write. If the working region was torn (its CRC doesn't match)
+	// or holds an invalid map, the uncommitted writes are discarded and the newest slot is loaded instead.
+	if (workingDirty)
+	{
+		memcpy (slotBuffer.map, physicalEeprom.cache, header->length);
+		migrate (header->version, slotBuffer.map, header->length, physicalEepromMap);
+		if (eepromMapValidate (physicalEepromMap))
+		{
+			dirty = header->version == EEPROM_MAP_VERSION;
+			return true;
+		}
+	}
+
+	// Migrate the newest slot into the working memory map.
+	if (slot != NULL)
+	{
+		migrate (slot->version, slot->map, slot->length, physicalEepromMap);
+		return true;
+	}
+
+	// No valid slot, carry the legacy memory map forward if it is valid. Note it is in the working map, so it is copied out
+	// before being migrated. If the store fails, the migrated map is still used, and is carried forward again on the next
+	// boot. A dirty working header means the working region has since been re-written, so no longer holds the legacy map.
+	if (!legacyValid || header->state == WORKING_STATE_DIRTY)
+		return false;
+
+	memcpy (slotBuffer.map, physicalEeprom.cache, LEGACY_SIZE);
+	migrate (LEGACY_VERSION, slotBuffer.map, LEGACY_SIZE, physicalEepromMap);
+	eepromSlotsStore (physicalEepromMap);
+	return true;
+}
+
+bool eepromSlotsStore (const eepromMap_t* map)
+{
+	uint16_t addr = activeSlotAddr == EEPROM_SLOT_A_ADDR ? EEPROM_SLOT_B_ADDR : EEPROM_SLOT_A_ADDR;
+
+	slotBuffer.sequence	= activeSequence + 1;
+	slotBuffer.version	= EEPROM_MAP_VERSION;
+	slotBuffer.length	= sizeof (eepromMap_t);
+	memcpy (slotBuffer.map, map, sizeof (eepromMap_t));
+	slotBuffer.crc		= eepromSlotsCrc32 ((const uint8_t*) &slotBuffer.sequence, crcLength (&slotBuffer));
+
+	if (!eepromSlotsWritePages (addr, &slotBuffer, offsetof (eepromSlot_t, map) + slotBuffer.length))
+		return false;
+
+	activeSlotAddr = addr;
+	activeSequence = slotBuffer.sequence;
+
+	// The stored map includes any direct writes, so the working memory map is no longer dirty.
+	if (dirty)
+	{
+		if (!writeWorkingHeader (WORKING_STATE_CLEAN))
+			return false;
+
+		dirty = false;
+	}
+
+	return true;
+}
+
+bool eepromSlotsWrite (uint16_t addr, const void* data, uint16_t dataCount)
+{
+	// The working region isn't written while the map is clean, so it is re-written from the working copy first. Note the
+	// cache holds the working copy, so each page is copied out before being written.
+	storing = true;
+	bool result = true;
+	for (uint16_t offset = 0; !dirty && result && offset < sizeof (eepromMap_t); offset += EEPROM_PAGE_SIZE)
+	{
+		uint8_t page [EEPROM_PAGE_SIZE];
+		uint16_t count = sizeof (eepromMap_t) - offset < EEPROM_PAGE_SIZE ? sizeof (eepromMap_t) - offset : EEPROM_PAGE_SIZE;
+		memcpy (page, &physicalEeprom.cache [offset], count);
+		result = eepromWrite ((eeprom_t*) &physicalEeprom, offset, page, count);
+	}
+	storing = false;
+
+	// The header is re-written after every write, so its CRC covers the write. If the write is torn, the CRC no longer matches
+	// and the newest slot is loaded on the next boot. Note the write itself isn't part of a store, so reconfigures the
+	// peripherals.
+	if (!result || !eepromWrite ((eeprom_t*) &physicalEeprom, addr, data, dataCount)
+		|| !writeWorkingHeader (WORKING_STATE_DIRTY))
+		return false;
+
+	dirty = true;
+	return true;
+}
+
+bool eepromSlotsDirty (void)
+{
+	return dirty;
+}
+
+bool eepromSlotsStoring (void)
+{
+	return storing;
+}
+
+uint32_t eepromSlotsCrc32 (const uint8_t* data, uint16_t dataCount)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint16_t index = 0; index < dataCount; ++index)
+	{
+		crc ^= data [index];
+		for (uint8_t bit = 0; bit < 8; ++bit)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
+
+bool eepromSlotsWritePages (uint16_t addr, const void* data, uint16_t dataCount)
+{
+	const uint8_t* buffer = data;
+	bool result = true;
+
+	// Note the offsets are relative to the address, so this assumes the address is page-aligned.
+	storing = true;
+	for (uint16_t offset = 0; result && offset < dataCount; offset += EEPROM_PAGE_SIZE)
+	{
+		uint16_t count = dataCount - offset < EEPROM_PAGE_SIZE ? dataCount - offset : EEPROM_PAGE_SIZE;
+		if (memcmp (&physicalEeprom.cache [addr + offset], &buffer [offset], count) == 0)
+			continue;
+
+		result = eepromWrite ((eeprom_t*) &physicalEeprom, addr + offset, &buffer [offset], count);
+	}
+	storing = false;
+
+	return result;
+}
\ No newline at end of file
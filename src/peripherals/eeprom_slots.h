@@ -0,0 +1,110 @@
+#ifndef EEPROM_SLOTS_H
+#define EEPROM_SLOTS_H
+
+// EEPROM Config Slots --------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Persistent storage of the EEPROM memory map in two CRC-protected slots (A / B). The memory map at the start of
+//   the physical EEPROM's cache is the working copy, which is loaded from the newest valid slot at boot. Stores only update it
+//   in RAM. When the map is stored, it is written to the older slot with an incremented sequence number, so a torn write (ex.
+//   a brown-out) leaves the newer slot intact and the previous configuration is loaded on the next boot.
+//
+//   The memory map may also be written directly, outside of a transaction. Direct writes are made to the working region at the
+//   start of the physical EEPROM, and the working header (just before the slots) marks the working memory map as dirty. The
+//   header is re-written after each direct write, recording the CRC of the working region. A dirty working memory map is
+//   loaded in place of the newest slot at boot if its CRC matches and it is valid, and is cleared the next time a map is
+//   stored. Otherwise (ex. a direct write was torn), its writes are discarded and the newest slot is loaded.
+//
+//   Each slot records the version of the memory map's layout. Slots written by an older firmware are carried forward using the
+//   migration table, so a layout change does not require the board to be reprogrammed.
+//
+//   Slot layout:
+//     0x00: CRC-32 of the rest of the slot, up to the end of the map (uint32_t).
+//     0x04: Sequence number, incremented on each store (uint32_t).
+//     0x08: Version of the memory map's layout, see @c EEPROM_MAP_VERSION (uint16_t).
+//     0x0A: Length of the memory map, in bytes (uint16_t).
+//     0x0C: The memory map.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/eeprom_map.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The addresses of the slots in the physical EEPROM. Slots are page-aligned.
+#define EEPROM_SLOT_A_ADDR	0x0C00
+#define EEPROM_SLOT_B_ADDR	0x0E00
+
+/// @brief The size of each slot, including its header.
+#define EEPROM_SLOT_SIZE	0x0200
+
+/// @brief The address of the working header in the physical EEPROM. Page-aligned, directly preceding the slots.
+#define EEPROM_WORKING_HEADER_ADDR	0x0BE0
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Loads the working memory map from the newest valid slot, or from the working region if it is marked dirty, its CRC
+ * matches, and it is valid. If neither slot is valid, the legacy memory map (stored at the start of the EEPROM) is stored into
+ * a slot, if it is valid.
+ * @param legacyValid Indicates the legacy memory map is valid, that is, its magic string matched.
+ * @return True if a valid memory map was loaded, false otherwise. Note a legacy memory map is still loaded if storing it
+ * fails. If false, the working memory map is left as-is and should not be used.
+ */
+bool eepromSlotsLoad (bool legacyValid);
+
+/**
+ * @brief Stores a memory map into the older slot, then clears the working memory map's dirty state. Neither updates the
+ * working memory map nor reconfigures the peripherals, see @c peripheralsApplyMap .
+ * @param map The memory map to store.
+ * @return True if successful, false if a write failed.
+ */
+bool eepromSlotsStore (const eepromMap_t* map);
+
+/**
+ * @brief Writes directly to the working memory map, marking it dirty. If it is not already dirty, the working region of the
+ * physical EEPROM is first re-written from the working copy. The working header's CRC is updated after the write.
+ * @param addr The address to write to. Must be within the memory map.
+ * @param data The data to write.
+ * @param dataCount The number of bytes to write.
+ * @return True if successful, false if a write failed.
+ */
+bool eepromSlotsWrite (uint16_t addr, const void* data, uint16_t dataCount);
+
+/**
+ * @brief Checks whether the working memory map has direct writes that have not been stored into a slot.
+ * @return True if the working memory map is dirty, false otherwise.
+ */
+bool eepromSlotsDirty (void);
+
+/**
+ * @brief Checks whether a record (a slot, the working header, or a record written by @c eepromSlotsWritePages ) is being
+ * written. Writes to the physical EEPROM made while this is true are not direct writes to the memory map, so don't require the
+ * peripherals to be reconfigured. Only meaningful to the thread holding the EEPROM mutex.
+ * @return True if a record is being written, false otherwise.
+ */
+bool eepromSlotsStoring (void);
+
+/**
+ * @brief Calculates the CRC-32 (IEEE 802.3) of a block of data. Used to validate the slots, and other records stored in the
+ * physical EEPROM.
+ * @param data The data to calculate the CRC of.
+ * @param dataCount The number of bytes of data.
+ * @return The CRC.
+ */
+uint32_t eepromSlotsCrc32 (const uint8_t* data, uint16_t dataCount);
+
+/**
+ * @brief Writes a block of data to the physical EEPROM in page-aligned bursts, skipping pages that already match. The caller
+ * must hold the EEPROM mutex.
+ * @param addr The address to write to. Must be page-aligned.
+ * @param data The data to write.
+ * @param dataCount The number of bytes to write.
+ * @return True if successful, false otherwise.
+ */
+bool eepromSlotsWritePages (uint16_t addr, const void* data, uint16_t dataCount);
+
+#endif // EEPROM_SLOTS_H
\ No newline at end of file
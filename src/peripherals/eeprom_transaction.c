@@ -0,0 +1,153 @@
+// Header
+#include "eeprom_transaction.h"
+
+// Includes
+#include "balancing.h"
+#include "peripherals.h"
+#include "peripherals/eeprom_slots.h"
+
+// C Standard Library
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The size of the memory map, writes to it are persisted through the config slots.
+#define MAP_SIZE			sizeof (eepromMap_t)
+
+/// @brief The range of addresses reserved for the working header and the config slots, [start, end).
+#define SLOTS_START			EEPROM_WORKING_HEADER_ADDR
+#define SLOTS_END			(EEPROM_SLOT_B_ADDR + EEPROM_SLOT_SIZE)
+
+/// @brief The range of addresses reserved for the balancing ledger, [start, end).
+#define LEDGER_START		BALANCING_LEDGER_ADDR
+#define LEDGER_END			(BALANCING_LEDGER_ADDR + sizeof (balancingLedger_t))
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief Indicates a transaction is open.
+static bool transactionOpen = false;
+
+/// @brief The staged contents of the memory map.
+static eepromMap_t staged;
+
+/// @brief Indicates the staged memory map has been written to.
+static bool stagedDirty;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Commits the open transaction, or the dirty working memory map. The EEPROM mutex must be held.
+ * @return True if successful, false otherwise, see @c eepromTransactionCommit .
+ */
+static bool commit (void)
+{
+	// With no transaction open, the direct writes made to the working memory map are committed.
+	if (!transactionOpen)
+		return eepromSlotsDirty () && eepromMapValidate (physicalEepromMap) && eepromSlotsStore (physicalEepromMap);
+
+	transactionOpen = false;
+
+	if (!stagedDirty)
+		return true;
+
+	if (!eepromMapValidate (&staged))
+		return false;
+
+	// Store the map into the next config slot, then apply it and reconfigure once.
+	if (!eepromSlotsStore (&staged))
+		return false;
+
+	peripheralsApplyMap (&staged);
+	return true;
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void eepromTransactionBegin (void)
+{
+	memcpy (&staged, physicalEepromMap, MAP_SIZE);
+	stagedDirty = false;
+	transactionOpen = true;
+}
+
+bool eepromTransactionCommit (void)
+{
+	chMtxLock (&eepromMutex);
+	bool result = commit ();
+	chMtxUnlock (&eepromMutex);
+	return result;
+}
+
+void eepromTransactionAbort (void)
+{
+	transactionOpen = false;
+}
+
+void eepromTransactionDirtyHook (void* caller)
+{
+	// Writes of the config slots are followed by a single reconfigure, see eepromTransactionCommit. Other records (ex. the
+	// balancing ledger) aren't part of the config, so don't reconfigure at all. Note the hook is called by the writing thread,
+	// which holds the EEPROM mutex.
+	if (!eepromSlotsStoring ())
+		peripheralsReconfigure (caller);
+}
+
+bool eepromTransactionRead (void* object, uint16_t addr, void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	if (!transactionOpen || addr >= MAP_SIZE)
+		return eepromRead ((eeprom_t*) &physicalEeprom, addr, data, dataCount);
+
+	if (addr + dataCount > MAP_SIZE)
+		return false;
+
+	memcpy (data, (uint8_t*) &staged + addr, dataCount);
+	return true;
+}
+
+bool eepromTransactionWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	(void) object;
+
+	// The working header and config slots may only be written through a commit.
+	if (addr + dataCount > SLOTS_START && addr < SLOTS_END)
+		return false;
+
+	// The balancing ledger is owned by the balancing loop, see balancingLedgerStore.
+	if (addr + dataCount > LEDGER_START && addr < LEDGER_END)
+		return false;
+
+	// Memory outside of the map isn't persisted through the slots.
+	if (addr >= MAP_SIZE)
+	{
+		chMtxLock (&eepromMutex);
+		bool result = eepromWrite ((eeprom_t*) &physicalEeprom, addr, data, dataCount);
+		chMtxUnlock (&eepromMutex);
+		return result;
+	}
+
+	if (addr + dataCount > MAP_SIZE)
+		return false;
+
+	// Writes outside of a transaction are written directly to the working memory map, which is marked dirty until the next
+	// commit. The write is first applied to a copy of the map (the staging buffer is unused with no transaction open), so a
+	// write that would leave the map invalid is rejected before the peripherals are reconfigured from it. Note the physical
+	// EEPROM's dirty hook reconfigures the peripherals.
+	if (!transactionOpen)
+	{
+		memcpy (&staged, physicalEepromMap, MAP_SIZE);
+		memcpy ((uint8_t*) &staged + addr, data, dataCount);
+		if (!eepromMapValidate (&staged))
+			return false;
+
+		chMtxLock (&eepromMutex);
+		bool result = eepromSlotsWrite (addr, data, dataCount);
+		chMtxUnlock (&eepromMutex);
+		return result;
+	}
+
+	memcpy ((uint8_t*) &staged + addr, data, dataCount);
+	stagedDirty = true;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef EEPROM_TRANSACTION_H
+#define EEPROM_TRANSACTION_H
+
+// EEPROM Transactions --------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Transactional writes to the physical EEPROM's memory map. This sits between the virtual EEPROM and the physical
+//   EEPROM. When a transaction is open, writes to the memory map are staged in RAM (and reads return the staged contents) until
+//   the transaction is committed. Writes to the memory map made outside of a transaction are written directly to the working
+//   memory map and mark it dirty. A direct write is rejected if it would leave the memory map invalid, so a map that is not
+//   yet valid (ex. an unprogrammed board) must be written through a transaction. Accesses outside of the memory map are passed
+//   straight through, with the exception of the working header, config slots, and balancing ledger, which cannot be written.
+//   Every write to the physical EEPROM is made holding the EEPROM mutex, see @c eepromMutex .
+//
+//   On commit, the staged memory map is validated as a whole, then stored into the next config slot (see
+//   peripherals/eeprom_slots.h) in page-aligned bursts. The peripherals are reconfigured exactly once, after the store. A
+//   commit with no transaction open validates and stores the dirty working memory map instead.
+//
+//   Transactions are controlled through the writeonly EEPROM, see eepromWriteonlyWrite.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/i2c/mc24lc32.h"
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens a transaction, discarding any previously staged writes.
+ */
+void eepromTransactionBegin (void);
+
+/**
+ * @brief Validates and writes the staged contents of the open transaction, then reconfigures the peripherals. If no
+ * transaction is open, validates and writes the working memory map if it is dirty.
+ * @return True if the transaction was committed, false if no transaction is open and the working memory map is clean, the
+ * contents are invalid, or a write failed. The transaction is closed in all cases.
+ */
+bool eepromTransactionCommit (void);
+
+/**
+ * @brief Closes the open transaction, discarding any staged writes.
+ */
+void eepromTransactionAbort (void);
+
+/**
+ * @brief Dirty hook of the physical EEPROM. Reconfigures the peripherals, unless a transaction is being committed.
+ * @param caller Ignored. Used to make function signature compatible with EEPROM dirty hook.
+ */
+void eepromTransactionDirtyHook (void* caller);
+
+bool eepromTransactionRead (void* object, uint16_t addr, void* data, uint16_t dataCount);
+
+bool eepromTransactionWrite (void* object, uint16_t addr, const void* data, uint16_t dataCount);
+
+#endif // EEPROM_TRANSACTION_H
\ No newline at end of file
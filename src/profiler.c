@@ -0,0 +1,97 @@
+// Header
+#include "profiler.h"
+
+// ChibiOS
+#include "hal.h"
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+profilerStats_t profilerStats [PROFILER_STAGE_COUNT];
+uint32_t profilerOverrunCount;
+uint32_t profilerBootTimes [PROFILER_BOOT_COUNT];
+
+/// @brief Indicates a reset has been requested, but not yet applied. See @c profilerReset .
+static volatile bool resetPending = false;
+
+// Private Functions ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Applies a pending reset, if any. Must only be called by the thread recording the statistics.
+ */
+static void applyReset (void)
+{
+	if (!resetPending)
+		return;
+
+	// Note the flag is cleared first, so a reset requested during the clear is applied on the next call.
+	resetPending = false;
+
+	for (uint16_t index = 0; index < PROFILER_STAGE_COUNT; ++index)
+	{
+		profilerStats [index] = (profilerStats_t)
+		{
+			.min		= UINT32_MAX,
+			.average	= 0,
+			.max		= 0,
+			.count		= 0,
+			.histogram	= {},
+			.sum		= 0
+		};
+	}
+
+	profilerOverrunCount = 0;
+}
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+void profilerReset (void)
+{
+	resetPending = true;
+}
+
+void profilerStop (profilerStage_t stage, rtcnt_t timeStart)
+{
+	// Note the realtime counter is free-running, so unsigned subtraction handles overflow.
+	uint32_t time = RTC2US (STM32_SYSCLK, chSysGetRealtimeCounterX () - timeStart);
+
+	applyReset ();
+	profilerStats_t* stats = &profilerStats [stage];
+
+	if (time < stats->min)
+		stats->min = time;
+
+	if (time > stats->max)
+		stats->max = time;
+
+	++stats->count;
+	stats->sum += time;
+	stats->average = stats->sum / stats->count;
+
+	// Find the bucket this measurement belongs to.
+	uint8_t bucket = 0;
+	uint32_t bound = PROFILER_HISTOGRAM_BASE;
+	while (time >= bound && bucket < PROFILER_HISTOGRAM_SIZE - 1)
+	{
+		bound <<= 2;
+		++bucket;
+	}
+
+	if (stats->histogram [bucket] != UINT16_MAX)
+		++stats->histogram [bucket];
+}
+
+void profilerRecordOverrun (void)
+{
+	applyReset ();
+	++profilerOverrunCount;
+}
+
+void profilerRecordBoot (profilerBootEvent_t event)
+{
+	if (profilerBootTimes [event] != 0)
+		return;
+
+	// Note the system time starts at 0 during chSysInit, shortly after reset. Saturate to 1 so the event reads as recorded.
+	uint32_t time = TIME_I2US (chVTGetSystemTimeX ());
+	profilerBootTimes [event] = time != 0 ? time : 1;
+}
\ No newline at end of file
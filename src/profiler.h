@@ -0,0 +1,123 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Monitor Profiler -----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Execution time profiler for the stages of the monitor thread. Each stage is timed using the realtime counter
+//   (DWT cycle counter) and tracked as a min / avg / max and a histogram. The results are accessible through the readonly
+//   EEPROM and a CAN diagnostic message, so the monitor loop can be profiled without a debugger attached.
+//
+//   The time taken to reach each stage of the boot process is also recorded, see @c profilerBootEvent_t .
+//
+//   The statistics are only ever written by the monitor thread. A reset requested from another thread (ex. the CAN thread
+//   handling the profiler reset command) is carried out by the monitor thread on its next measurement.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// ChibiOS
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The number of buckets in each stage's histogram.
+#define PROFILER_HISTOGRAM_SIZE 8
+
+/// @brief The upper bound of the first histogram bucket, in microseconds. Each following bucket's bound is 4 times larger than
+/// the previous, the last bucket is unbounded. For a base of 64 us, the last bucket contains everything above 262 ms.
+#define PROFILER_HISTOGRAM_BASE 64
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	PROFILER_STAGE_CYCLE			= 0,	// Entire monitor cycle, excluding the sleep.
+	PROFILER_STAGE_MUTEX_HOLD		= 1,	// Time the peripheral mutex is held for, per hold. Excludes the relaxation.
+	PROFILER_STAGE_SAMPLE_CELLS		= 2,	// ltc6811SampleCells
+	PROFILER_STAGE_CELL_FAULTS		= 3,	// ltc6811SampleCellVoltageFaults
+	PROFILER_STAGE_SAMPLE_STATUS	= 4,	// ltc6811SampleStatus
+	PROFILER_STAGE_SAMPLE_GPIO		= 5,	// ltc6811SampleGpio
+	PROFILER_STAGE_OPEN_WIRE_TEST	= 6,	// ltc6811OpenWireTest
+	PROFILER_STAGE_WRITE_CONFIG		= 7,	// ltc6811WriteConfig
+	PROFILER_STAGE_SAMPLE_ADC		= 8,	// stmAdcSample
+	PROFILER_STAGE_TRANSMIT			= 9,	// transmitBmsMessages (queueing only)
+	PROFILER_STAGE_RELAXATION		= 10,	// Discharge suspension and cell relaxation, prior to ltc6811SampleCells.
+	PROFILER_STAGE_ACQUISITION		= 11,	// Entire LTC acquisition, from ltc6811SampleCells to ltc6811WriteConfig.
+	PROFILER_STAGE_COUNT			= 12
+} profilerStage_t;
+
+typedef enum
+{
+	PROFILER_BOOT_PERIPHERALS		= 0,	// peripheralsInit complete, including the EEPROM load.
+	PROFILER_BOOT_FIRST_LTC_SAMPLE	= 1,	// First ltc6811SampleCells complete.
+	PROFILER_BOOT_FIRST_CAN_FRAME	= 2,	// First CAN frame transmitted.
+	PROFILER_BOOT_COUNT				= 3
+} profilerBootEvent_t;
+
+typedef struct
+{
+	/// @brief The minimum execution time of the stage, in microseconds.
+	uint32_t min;
+	/// @brief The average execution time of the stage, in microseconds.
+	uint32_t average;
+	/// @brief The maximum execution time of the stage, in microseconds.
+	uint32_t max;
+	/// @brief The number of times the stage has been measured.
+	uint32_t count;
+	/// @brief Histogram of the execution times, see @c PROFILER_HISTOGRAM_BASE for bucket bounds. Each bucket saturates at
+	/// its maximum value.
+	uint16_t histogram [PROFILER_HISTOGRAM_SIZE];
+	/// @brief The accumulated execution time of the stage, in microseconds.
+	uint64_t sum;
+} profilerStats_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The statistics of each stage, indexed by @c profilerStage_t .
+extern profilerStats_t profilerStats [PROFILER_STAGE_COUNT];
+
+/// @brief The number of cycles the monitor thread has failed to complete within its period.
+extern uint32_t profilerOverrunCount;
+
+/// @brief The time from boot until each boot event, in microseconds, indexed by @c profilerBootEvent_t . 0 if the event has
+/// not yet occurred. Not cleared by @c profilerReset .
+extern uint32_t profilerBootTimes [PROFILER_BOOT_COUNT];
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Requests the statistics of all stages, and the overrun count, be reset. The reset is applied on the next measurement
+ * or overrun, by the thread recording them. May be called from any thread.
+ */
+void profilerReset (void);
+
+/**
+ * @brief Starts the measurement of a stage.
+ * @return The start timestamp, to be passed to @c profilerStop .
+ */
+static inline rtcnt_t profilerStart (void)
+{
+	return chSysGetRealtimeCounterX ();
+}
+
+/**
+ * @brief Stops the measurement of a stage, updating its statistics.
+ * @param stage The stage that was measured.
+ * @param timeStart The timestamp returned by @c profilerStart .
+ */
+void profilerStop (profilerStage_t stage, rtcnt_t timeStart);
+
+/**
+ * @brief Records that the monitor thread failed to complete a cycle within its period.
+ */
+void profilerRecordOverrun (void);
+
+/**
+ * @brief Records the time of a boot event, if it has not already been recorded.
+ * @param event The event that occurred.
+ */
+void profilerRecordBoot (profilerBootEvent_t event);
+
+#endif // PROFILER_H
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Balancing Planner Test -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Checks the planner (balancingPlan) against the per-LTC sort it replaced, then benchmarks both. The packs are
+//   random, with the values quantized to 1 mV so ties between cells are exercised. Each LTC is given a different balance
+//   count, covering 0 to the full LTC.
+
+// Includes
+#include "balancing.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The largest pack tested, in LTCs.
+#define LTC_COUNT_MAX		24
+
+/// @brief The number of random packs checked for each size.
+#define TRIAL_COUNT			10000
+
+/// @brief The number of plans timed for each size, per run.
+#define BENCHMARK_COUNT		20000
+
+/// @brief The number of timed runs for each size, the fastest run is reported.
+#define BENCHMARK_RUN_COUNT	10
+
+/// @brief The balancing threshold, in volts.
+#define THRESHOLD			0.010f
+
+// Reference Planner ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief The original planner: the pack minimum is found first, then each LTC's cells are sorted from highest to lowest and
+ * the first cells are checked against the threshold. Note the sort is stable, as a tie is resolved in favor of the lower cell
+ * index.
+ */
+static void referencePlan (const float values [][LTC6811_CELL_COUNT], uint16_t ltcCount, const uint8_t* balanceCounts,
+	float threshold, uint16_t* dischargeMasks)
+{
+	float minValue = values [0][0];
+	for (uint16_t ltc = 0; ltc < ltcCount; ++ltc)
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+			if (values [ltc][cell] < minValue)
+				minValue = values [ltc][cell];
+
+	for (uint16_t ltc = 0; ltc < ltcCount; ++ltc)
+	{
+		uint8_t sortedIndices [LTC6811_CELL_COUNT];
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+			sortedIndices [cell] = cell;
+
+		// Insertion sort, from highest to lowest.
+		for (uint8_t index = 1; index < LTC6811_CELL_COUNT; ++index)
+		{
+			uint8_t cell = sortedIndices [index];
+			uint8_t position = index;
+			while (position > 0 && values [ltc][cell] > values [ltc][sortedIndices [position - 1]])
+			{
+				sortedIndices [position] = sortedIndices [position - 1];
+				--position;
+			}
+			sortedIndices [position] = cell;
+		}
+
+		uint8_t balanceCount = balanceCounts [ltc] < LTC6811_CELL_COUNT ? balanceCounts [ltc] : LTC6811_CELL_COUNT;
+		dischargeMasks [ltc] = 0;
+		for (uint8_t index = 0; index < balanceCount; ++index)
+			if (values [ltc][sortedIndices [index]] - minValue > threshold)
+				dischargeMasks [ltc] |= 1 << sortedIndices [index];
+	}
+}
+
+// Test Functions -------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills a pack with random cell voltages, quantized to 1 mV, and random balance counts.
+ */
+static void randomPack (float values [][LTC6811_CELL_COUNT], uint16_t ltcCount, uint8_t* balanceCounts)
+{
+	for (uint16_t ltc = 0; ltc < ltcCount; ++ltc)
+	{
+		for (uint8_t cell = 0; cell < LTC6811_CELL_COUNT; ++cell)
+			values [ltc][cell] = 3.900f + (rand () % 50) * 0.001f;
+
+		balanceCounts [ltc] = rand () % (LTC6811_CELL_COUNT + 2);
+	}
+}
+
+/**
+ * @brief Gets the time elapsed since a previous time.
+ * @return The time, in nanoseconds.
+ */
+static double elapsed (const struct timespec* start)
+{
+	struct timespec end;
+	clock_gettime (CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Checks the planner against the reference for a size of pack, then benchmarks both.
+ * @return True if every plan matched, false otherwise.
+ */
+static bool testPackSize (uint16_t ltcCount)
+{
+	static float values [LTC_COUNT_MAX][LTC6811_CELL_COUNT];
+	uint8_t balanceCounts [LTC_COUNT_MAX];
+	uint16_t masks [LTC_COUNT_MAX];
+	uint16_t referenceMasks [LTC_COUNT_MAX];
+
+	for (uint32_t trial = 0; trial < TRIAL_COUNT; ++trial)
+	{
+		randomPack (values, ltcCount, balanceCounts);
+		balancingPlan (values, ltcCount, balanceCounts, THRESHOLD, masks);
+		referencePlan (values, ltcCount, balanceCounts, THRESHOLD, referenceMasks);
+
+		if (memcmp (masks, referenceMasks, ltcCount * sizeof (uint16_t)) != 0)
+		{
+			printf ("FAIL: %u cells, trial %u: plan differs from the reference.\n", ltcCount * LTC6811_CELL_COUNT, trial);
+			return false;
+		}
+	}
+
+	// Benchmark both on the same pack, alternating between them and keeping the fastest run of each, so neither is skewed by
+	// the other's warm-up or by the host's scheduling. The masks are accumulated so the plans aren't optimized out.
+	randomPack (values, ltcCount, balanceCounts);
+	uint16_t checksum = 0;
+	struct timespec start;
+	double timePlan = INFINITY;
+	double timeReference = INFINITY;
+
+	for (uint8_t run = 0; run < BENCHMARK_RUN_COUNT; ++run)
+	{
+		clock_gettime (CLOCK_MONOTONIC, &start);
+		for (uint32_t index = 0; index < BENCHMARK_COUNT; ++index)
+		{
+			balancingPlan (values, ltcCount, balanceCounts, THRESHOLD, masks);
+			checksum += masks [index % ltcCount];
+		}
+		timePlan = fmin (timePlan, elapsed (&start) / BENCHMARK_COUNT);
+
+		clock_gettime (CLOCK_MONOTONIC, &start);
+		for (uint32_t index = 0; index < BENCHMARK_COUNT; ++index)
+		{
+			referencePlan (values, ltcCount, balanceCounts, THRESHOLD, masks);
+			checksum += masks [index % ltcCount];
+		}
+		timeReference = fmin (timeReference, elapsed (&start) / BENCHMARK_COUNT);
+	}
+
+	printf ("PASS: %u cells, planner %.0f ns, sort %.0f ns (checksum %u).\n", ltcCount * LTC6811_CELL_COUNT, timePlan,
+		timeReference, checksum);
+	return true;
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	srand (1);
+
+	bool result = true;
+	result &= testPackSize (12);
+	result &= testPackSize (24);
+
+	return result ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+// CAN Signal Layout Test -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Checks the layouts of the table-driven CAN messages (can/transmit_signals.h) by decoding frames packed from
+//   them. Each signal must lie within its message's DLC and not overlap another signal, and no two messages may share an ID.
+//   Every signal is then packed and decoded at the bounds and the middle of its range, alongside the other signals of its
+//   message at their maximum, so a layout error is caught before it reaches the car.
+
+// Includes
+#include "can/transmit_signals.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	const char* name;
+	uint16_t id;
+	uint16_t count;
+	uint8_t dlc;
+	const canSignal_t* signals;
+	uint8_t signalCount;
+} message_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+#define MESSAGE_ENTRY(name, id, count, dlc, signals) { (name), (id), (count), (dlc), (signals), SIGNAL_COUNT (signals) },
+static const message_t MESSAGES [] =
+{
+	TRANSMIT_SIGNAL_MESSAGES (MESSAGE_ENTRY)
+};
+
+#define MESSAGE_COUNT (sizeof (MESSAGES) / sizeof (MESSAGES [0]))
+
+static bool result = true;
+
+// Test Functions -------------------------------------------------------------------------------------------------------------
+
+#define CHECK(condition, message, signal)																						\
+	do																															\
+	{																															\
+		if (!(condition))																										\
+		{																														\
+			printf ("FAIL: %s:%u: %s %s: %s\n", __FILE__, __LINE__, (message)->name, (signal), #condition);					\
+			result = false;																										\
+		}																														\
+	} while (0)
+
+/**
+ * @brief Gets the bounds of a signal's raw value.
+ */
+static void getRawRange (const canSignal_t* signal, int32_t* rawMin, int32_t* rawMax)
+{
+	*rawMin = signal->isSigned ? -(1 << (signal->length - 1)) : 0;
+	*rawMax = signal->isSigned ? (1 << (signal->length - 1)) - 1 : (1 << signal->length) - 1;
+}
+
+/**
+ * @brief Gets the physical value that encodes to a raw value. The value is placed within the raw value's LSB, so rounding
+ * errors don't truncate it to the neighbouring value.
+ */
+static float getValue (const canSignal_t* signal, int32_t raw)
+{
+	return (raw + (raw < 0 ? -0.25f : 0.25f)) * signal->scale + signal->offset;
+}
+
+/**
+ * @brief Checks a decoded value matches the physical value of a raw value.
+ */
+static bool decodeMatches (const canSignal_t* signal, uint64_t payload, int32_t raw)
+{
+	float expected = raw * signal->scale + signal->offset;
+	return fabsf (canSignalDecode (signal, payload) - expected) <= fabsf (signal->scale) * 0.01f + fabsf (expected) * 1e-6f;
+}
+
+/**
+ * @brief Checks each signal of a message lies within its DLC, and that no two signals overlap.
+ */
+static void testLayout (const message_t* message)
+{
+	uint64_t mask = 0;
+	for (uint8_t index = 0; index < message->signalCount; ++index)
+	{
+		const canSignal_t* signal = &message->signals [index];
+		CHECK (signal->length >= 1 && signal->length <= 16, message, signal->name);
+		CHECK (signal->startBit + signal->length <= message->dlc * 8, message, signal->name);
+
+		uint64_t signalMask = ((UINT64_C (1) << signal->length) - 1) << signal->startBit;
+		CHECK ((mask & signalMask) == 0, message, signal->name);
+		mask |= signalMask;
+
+		for (uint8_t other = 0; other < index; ++other)
+			CHECK (strcmp (signal->name, message->signals [other].name) != 0, message, signal->name);
+	}
+}
+
+/**
+ * @brief Checks no ID of a message is shared with another message.
+ */
+static void testIds (const message_t* message)
+{
+	for (const message_t* other = MESSAGES; other < message; ++other)
+		CHECK (message->id + message->count <= other->id || other->id + other->count <= message->id, message, other->name);
+}
+
+/**
+ * @brief Packs and decodes each signal of a message at the bounds and the middle of its range. The other signals are packed
+ * at their maximum, so any overlap corrupts one of the values.
+ */
+static void testRoundTrip (const message_t* message)
+{
+	for (uint8_t index = 0; index < message->signalCount; ++index)
+	{
+		const canSignal_t* signal = &message->signals [index];
+
+		int32_t rawMin;
+		int32_t rawMax;
+		getRawRange (signal, &rawMin, &rawMax);
+		int32_t raws [] = { rawMin, rawMin + (rawMax - rawMin) / 2, rawMax };
+
+		for (uint8_t rawIndex = 0; rawIndex < sizeof (raws) / sizeof (raws [0]); ++rawIndex)
+		{
+			float values [message->signalCount];
+			int32_t expected [message->signalCount];
+			for (uint8_t other = 0; other < message->signalCount; ++other)
+			{
+				int32_t otherMin;
+				getRawRange (&message->signals [other], &otherMin, &expected [other]);
+				values [other] = getValue (&message->signals [other], expected [other]);
+			}
+			expected [index] = raws [rawIndex];
+			values [index] = getValue (signal, raws [rawIndex]);
+
+			CANTxFrame frame = { .DLC = message->dlc };
+			uint16_t packedRaws [message->signalCount];
+			canSignalPack (&frame, message->signals, values, packedRaws, message->signalCount);
+
+			for (uint8_t other = 0; other < message->signalCount; ++other)
+				CHECK (decodeMatches (&message->signals [other], frame.data64 [0], expected [other]), message,
+					message->signals [other].name);
+		}
+
+		// Out of range values are saturated, NaN to the minimum.
+		CHECK (canSignalEncode (signal, INFINITY) == (uint16_t) (rawMax & ((1 << signal->length) - 1)), message, signal->name);
+		CHECK (canSignalEncode (signal, -INFINITY) == (uint16_t) (rawMin & ((1 << signal->length) - 1)), message, signal->name);
+		CHECK (canSignalEncode (signal, NAN) == (uint16_t) (rawMin & ((1 << signal->length) - 1)), message, signal->name);
+	}
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	for (const message_t* message = MESSAGES; message < MESSAGES + MESSAGE_COUNT; ++message)
+	{
+		testLayout (message);
+		testIds (message);
+		testRoundTrip (message);
+	}
+
+	if (result)
+		printf ("PASS: %u CAN message layouts.\n", (unsigned) MESSAGE_COUNT);
+
+	return result ? 0 : 1;
+}
\ No newline at end of file
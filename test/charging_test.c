@@ -0,0 +1,245 @@
+// Charge Controller Test -----------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Checks the charge controller's termination (chargingUpdate). A temporary drop of the current limit during the
+//   constant voltage stage, either by derating or by the charger dropping out, must not terminate the charge once the limit
+//   recovers. A simulated pack charged to a target below the overvoltage limit must complete without reaching the limit.
+//   Invalid inputs must result in no current being requested.
+
+// Includes
+#include "charging.h"
+
+// C Standard Library
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The period of the updates, in seconds.
+#define PERIOD 0.25f
+
+/// @brief The target and integral gain of the simulated charge, the defaults of the memory map.
+#define CELL_VOLTAGE_TARGET 4.14f
+#define INTEGRAL_GAIN 20.0f
+
+/// @brief The internal resistance of the simulated cells, in ohms.
+#define CELL_RESISTANCE 0.005f
+
+/// @brief The rise of the simulated cells' open-circuit voltage with the charge put in, in volts per amp-second.
+#define CELL_VOLTAGE_RISE 0.0001f
+
+/// @brief The maximum number of updates the simulated charge may take.
+#define SIMULATION_COUNT_MAX 20000
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+static packSnapshot_t snapshot;
+
+static bool result = true;
+
+// Test Functions -------------------------------------------------------------------------------------------------------------
+
+#define CHECK(condition)																										\
+	do																															\
+	{																															\
+		if (!(condition))																										\
+		{																														\
+			printf ("FAIL: %s:%u: %s\n", __FILE__, __LINE__, #condition);														\
+			result = false;																										\
+		}																														\
+	} while (0)
+
+/**
+ * @brief Programs the memory map with a typical configuration. The current limit is bound by the charging current limit of
+ * 20 A, rather than the power limit.
+ */
+static void configure (void)
+{
+	static const float OCV_VOLTAGES [EEPROM_OCV_POINT_COUNT] =
+	{
+		3.00f, 3.45f, 3.55f, 3.62f, 3.68f, 3.75f, 3.85f, 3.95f, 4.03f, 4.10f, 4.20f
+	};
+	static const float DERATING_TEMPERATURES [EEPROM_DERATING_POINT_COUNT] =
+	{
+		-10.0f, 0.0f, 10.0f, 45.0f, 55.0f, 60.0f
+	};
+	static const float DERATING_FACTORS [EEPROM_DERATING_POINT_COUNT] =
+	{
+		0.0f, 0.1f, 1.0f, 1.0f, 0.25f, 0.0f
+	};
+
+	memset (physicalEepromMap, 0, sizeof (eepromMap_t));
+	physicalEepromMap->chargingVoltageLimit			= 600.0f;
+	physicalEepromMap->chargingCurrentLimit			= 20.0f;
+	physicalEepromMap->chargingPowerLimit			= 10000.0f;
+	physicalEepromMap->chargingThreshold			= 1.0f;
+	physicalEepromMap->chargingCellVoltageTarget	= 4.2f;
+	physicalEepromMap->chargingProportionalGain		= 50.0f;
+	physicalEepromMap->chargingIntegralGain			= 5.0f;
+	physicalEepromMap->cellCapacity					= 4.5f;
+	memcpy (physicalEepromMap->ocvVoltages, OCV_VOLTAGES, sizeof (OCV_VOLTAGES));
+	memcpy (physicalEepromMap->deratingTemperatures, DERATING_TEMPERATURES, sizeof (DERATING_TEMPERATURES));
+	memcpy (physicalEepromMap->deratingFactors, DERATING_FACTORS, sizeof (DERATING_FACTORS));
+}
+
+/**
+ * @brief Sets the snapshot's inputs to the charge controller.
+ */
+static void setSnapshot (float cellVoltageMax, float temperature, float packVoltage)
+{
+	snapshot.cellVoltageMax	= cellVoltageMax;
+	snapshot.temperatureMin	= temperature;
+	snapshot.temperatureMax	= temperature;
+	snapshot.packVoltage	= packVoltage;
+}
+
+/**
+ * @brief Runs the charge controller for a number of updates.
+ * @return The last current request.
+ */
+static float run (uint16_t count, bool chargerAvailable)
+{
+	float request = 0.0f;
+	for (uint16_t index = 0; index < count; ++index)
+		request = chargingUpdate (&snapshot, PERIOD, chargerAvailable);
+
+	return request;
+}
+
+/**
+ * @brief Charges into the constant voltage stage, then tapers the integral to 10 A.
+ */
+static void startTaper (void)
+{
+	chargingStop ();
+
+	// Constant current.
+	setSnapshot (4.10f, 25.0f, 500.0f);
+	CHECK (run (1, true) == 20.0f);
+	CHECK (chargingState == CHARGING_STATE_CONSTANT_CURRENT);
+
+	// Constant voltage, tapering at 0.125 A per update.
+	setSnapshot (4.30f, 25.0f, 500.0f);
+	run (80, true);
+	CHECK (chargingState == CHARGING_STATE_CONSTANT_VOLTAGE);
+}
+
+/**
+ * @brief Checks a temporary limit drop doesn't terminate the charge, then that the charge still terminates on the taper.
+ * @param temperature The temperature during the drop.
+ * @param chargerAvailable Indicates the charger is available during the drop.
+ */
+static void testLimitDrop (float temperature, bool chargerAvailable)
+{
+	startTaper ();
+
+	// Drop the limit to 0.
+	setSnapshot (4.20f, temperature, 500.0f);
+	CHECK (run (4, chargerAvailable) == 0.0f);
+	CHECK (chargingState == CHARGING_STATE_CONSTANT_VOLTAGE);
+
+	// Recover, the charge must not be terminated.
+	setSnapshot (4.20f, 25.0f, 500.0f);
+	run (4, true);
+	CHECK (chargingState == CHARGING_STATE_CONSTANT_VOLTAGE);
+
+	// The cells relax, so the loop regulates back up above the termination current.
+	setSnapshot (4.10f, 25.0f, 500.0f);
+	run (40, true);
+	CHECK (chargingState == CHARGING_STATE_CONSTANT_VOLTAGE);
+
+	// Then tapers down to it, terminating the charge.
+	setSnapshot (4.30f, 25.0f, 500.0f);
+	CHECK (run (80, true) == 0.0f);
+	CHECK (chargingState == CHARGING_STATE_COMPLETE);
+}
+
+/**
+ * @brief Charges a simulated pack to a target below the overvoltage limit. The cells are modelled as an open-circuit voltage,
+ * rising with the charge put in, in series with an internal resistance. The charge must complete, with the cells regulated to
+ * the target and never reaching the limit.
+ */
+static void testConstantVoltage (void)
+{
+	eepromMap_t mapPrevious = *physicalEepromMap;
+	physicalEepromMap->chargingCellVoltageTarget = CELL_VOLTAGE_TARGET;
+	physicalEepromMap->chargingIntegralGain = INTEGRAL_GAIN;
+	CHECK (CELL_VOLTAGE_TARGET < CELL_VOLTAGE_MAX);
+
+	chargingStop ();
+	float openCircuitVoltage = 3.90f;
+	float current = 0.0f;
+	float cellVoltagePeak = 0.0f;
+	uint16_t count = 0;
+	while (chargingState != CHARGING_STATE_COMPLETE && count < SIMULATION_COUNT_MAX)
+	{
+		float cellVoltage = openCircuitVoltage + current * CELL_RESISTANCE;
+		if (cellVoltage > cellVoltagePeak)
+			cellVoltagePeak = cellVoltage;
+
+		setSnapshot (cellVoltage, 25.0f, 500.0f);
+		current = chargingUpdate (&snapshot, PERIOD, true);
+		openCircuitVoltage += current * PERIOD * CELL_VOLTAGE_RISE;
+		++count;
+	}
+
+	CHECK (chargingState == CHARGING_STATE_COMPLETE);
+	CHECK (cellVoltagePeak < CELL_VOLTAGE_MAX);
+
+	// Terminated at the threshold current, so the cells are within its drop of the target.
+	CHECK (openCircuitVoltage > CELL_VOLTAGE_TARGET - physicalEepromMap->chargingThreshold * CELL_RESISTANCE - 0.001f);
+	CHECK (openCircuitVoltage < CELL_VOLTAGE_TARGET + 0.001f);
+
+	*physicalEepromMap = mapPrevious;
+}
+
+/**
+ * @brief Checks invalid inputs don't result in a request.
+ */
+static void testInvalidInputs (void)
+{
+	// Pack voltage.
+	chargingStop ();
+	setSnapshot (4.10f, 25.0f, NAN);
+	CHECK (run (1, true) == 0.0f);
+
+	chargingStop ();
+	setSnapshot (4.10f, 25.0f, 0.0f);
+	CHECK (run (1, true) == 0.0f);
+
+	// Temperatures.
+	chargingStop ();
+	setSnapshot (4.10f, NAN, 500.0f);
+	CHECK (run (1, true) == 0.0f);
+
+	// Cell voltage.
+	chargingStop ();
+	setSnapshot (NAN, 25.0f, 500.0f);
+	CHECK (run (1, true) == 0.0f);
+	CHECK (chargingState != CHARGING_STATE_COMPLETE);
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	configure ();
+
+	// Derating to 0.
+	testLimitDrop (60.0f, true);
+
+	// Charger dropping out.
+	testLimitDrop (25.0f, false);
+
+	testConstantVoltage ();
+
+	testInvalidInputs ();
+
+	if (result)
+		printf ("PASS: charging termination, constant voltage, and invalid inputs.\n");
+
+	return result ? 0 : 1;
+}
\ No newline at end of file
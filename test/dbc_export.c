@@ -0,0 +1,62 @@
+// DBC Exporter ---------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Exports the table-driven CAN messages (can/transmit_signals.h) as a DBC, written to stdout. Run with
+//   'make dbc' from this directory, which writes build/bms.dbc. Messages sent with consecutive IDs are exported once per ID,
+//   suffixed by their index.
+
+// Includes
+#include "can/transmit_signals.h"
+
+// C Standard Library
+#include <stdio.h>
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the definition of a signal.
+ */
+static void exportSignal (const canSignal_t* signal)
+{
+	int32_t rawMin = signal->isSigned ? -(1 << (signal->length - 1)) : 0;
+	int32_t rawMax = signal->isSigned ? (1 << (signal->length - 1)) - 1 : (1 << signal->length) - 1;
+
+	printf (" SG_ %s : %u|%u@1%c (%.9g,%.9g) [%.9g|%.9g] \"\" Vector__XXX\n", signal->name, signal->startBit, signal->length,
+		signal->isSigned ? '-' : '+', signal->scale, signal->offset, rawMin * signal->scale + signal->offset,
+		rawMax * signal->scale + signal->offset);
+}
+
+/**
+ * @brief Writes the definition of a message, once for each of its IDs.
+ */
+static void exportMessage (const char* name, uint16_t id, uint16_t count, uint8_t dlc, const canSignal_t* signals,
+	uint8_t signalCount)
+{
+	for (uint16_t index = 0; index < count; ++index)
+	{
+		if (count == 1)
+			printf ("BO_ %u %s: %u BMS\n", id, name, dlc);
+		else
+			printf ("BO_ %u %s_%u: %u BMS\n", id + index, name, index, dlc);
+
+		for (uint8_t signalIndex = 0; signalIndex < signalCount; ++signalIndex)
+			exportSignal (&signals [signalIndex]);
+
+		printf ("\n");
+	}
+}
+
+// Entrypoint -----------------------------------------------------------------------------------------------------------------
+
+int main (void)
+{
+	printf ("VERSION \"\"\n\nNS_ :\n\nBS_:\n\nBU_: BMS\n\n");
+
+	#define EXPORT_MESSAGE(name, id, count, dlc, signals) exportMessage ((name), (id), (count), (dlc), (signals),			\
+		SIGNAL_COUNT (signals));
+	TRANSMIT_SIGNAL_MESSAGES (EXPORT_MESSAGE)
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+// Host Stubs -----------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Definitions of the global peripherals and the ChibiOS / common library functions the modules under test link
+//   against. See the headers in test/stubs.
+
+// Includes
+#include "peripherals.h"
+#include "monitor_thread.h"
+
+// C Standard Library
+#include <string.h>
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+systime_t stubSystemTime = 0;
+
+mutex_t peripheralMutex;
+
+mutex_t eepromMutex;
+
+mc24lc32_t physicalEeprom;
+
+ltc6811_t ltcs [LTC_COUNT];
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool eepromWrite (eeprom_t* eeprom, uint16_t addr, const void* data, uint16_t dataCount)
+{
+	if (addr + dataCount > MC24LC32_SIZE)
+		return false;
+
+	memcpy (&((mc24lc32_t*) eeprom)->cache [addr], data, dataCount);
+	return true;
+}
+
+void monitorSetCellDischarging (uint16_t ltcIndex, uint16_t cellIndex, bool discharging)
+{
+	ltcs [ltcIndex].cellsDischarging [cellIndex] = discharging;
+}
+
+bool eepromMapValidate (const eepromMap_t* map)
+{
+	(void) map;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef CH_H
+#define CH_H
+
+// ChibiOS Stub ---------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the parts of the ChibiOS RT API used by the modules under test. The system time is a plain
+//   variable, advanced by the test itself.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// C Standard Library
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+/// @brief The frequency of the system tick, matching config/chconf.h.
+#define CH_CFG_ST_FREQUENCY 10000
+
+#define TIME_S2I(secs)	((sysinterval_t) ((secs) * CH_CFG_ST_FREQUENCY))
+#define TIME_MS2I(msecs)	((sysinterval_t) ((msecs) * CH_CFG_ST_FREQUENCY / 1000))
+#define TIME_I2MS(interval)	((time_msecs_t) ((interval) * 1000 / CH_CFG_ST_FREQUENCY))
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef uint32_t systime_t;
+typedef uint32_t sysinterval_t;
+typedef uint32_t time_msecs_t;
+typedef uint32_t rtcnt_t;
+typedef uint32_t tprio_t;
+
+typedef struct
+{
+	bool locked;
+} mutex_t;
+
+// Global State ---------------------------------------------------------------------------------------------------------------
+
+/// @brief The current system time, in ticks.
+extern systime_t stubSystemTime;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+static inline systime_t chVTGetSystemTimeX (void)
+{
+	return stubSystemTime;
+}
+
+static inline sysinterval_t chTimeDiffX (systime_t start, systime_t end)
+{
+	return (sysinterval_t) (end - start);
+}
+
+static inline systime_t chTimeAddX (systime_t time, sysinterval_t interval)
+{
+	return time + interval;
+}
+
+static inline void chMtxLock (mutex_t* mutex)
+{
+	mutex->locked = true;
+}
+
+static inline void chMtxUnlock (mutex_t* mutex)
+{
+	mutex->locked = false;
+}
+
+#endif // CH_H
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef HAL_H
+#define HAL_H
+
+// ChibiOS HAL Stub -----------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the ChibiOS HAL. None of the HAL drivers are used by the modules under test, only the CAN
+//   frame is provided, for the signal packing.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "ch.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define CAN_IDE_STD 0
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint8_t DLC;
+	uint8_t IDE;
+	uint32_t SID;
+	union
+	{
+		uint8_t data8 [8];
+		uint16_t data16 [4];
+		uint32_t data32 [2];
+		uint64_t data64 [1];
+	};
+} CANTxFrame;
+
+#endif // HAL_H
\ No newline at end of file
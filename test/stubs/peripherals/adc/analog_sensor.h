@@ -0,0 +1,31 @@
+#ifndef ANALOG_SENSOR_H
+#define ANALOG_SENSOR_H
+
+// Analog Sensor Stub ---------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's analog sensor base.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "hal.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	ANALOG_SENSOR_FAILED			= 0,
+	ANALOG_SENSOR_CONFIG_INVALID	= 1,
+	ANALOG_SENSOR_VALID				= 2,
+	ANALOG_SENSOR_SAMPLE_INVALID	= 3
+} analogSensorState_t;
+
+typedef struct
+{
+	analogSensorState_t state;
+} analogSensor_t;
+
+#endif // ANALOG_SENSOR_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef DHAB_S124_H
+#define DHAB_S124_H
+
+// Current Sensor Stub --------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's DHAB S124 current sensor. The config is sized to match the memory map.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/adc/analog_sensor.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint8_t data [0x20];
+} dhabS124Config_t;
+
+typedef struct
+{
+	analogSensorState_t state;
+	float value;
+} dhabS124_t;
+
+#endif // DHAB_S124_H
\ No newline at end of file
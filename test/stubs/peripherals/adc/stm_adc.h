@@ -0,0 +1,23 @@
+#ifndef STM_ADC_H
+#define STM_ADC_H
+
+// STM ADC Stub ---------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's STM32 ADC driver.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/adc/analog_sensor.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	bool started;
+} stmAdc_t;
+
+#endif // STM_ADC_H
\ No newline at end of file
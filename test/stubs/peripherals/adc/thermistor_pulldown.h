@@ -0,0 +1,31 @@
+#ifndef THERMISTOR_PULLDOWN_H
+#define THERMISTOR_PULLDOWN_H
+
+// Thermistor Stub ------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's pulldown thermistor. The config is sized to match the memory map.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/adc/analog_sensor.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	uint8_t data [0x20];
+} thermistorPulldownConfig_t;
+
+typedef struct
+{
+	analogSensorState_t state;
+	float temperature;
+	bool undertemperatureFault;
+	bool overtemperatureFault;
+} thermistorPulldown_t;
+
+#endif // THERMISTOR_PULLDOWN_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef EEPROM_H
+#define EEPROM_H
+
+// EEPROM Interface Stub ------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's generic EEPROM interface. Writes are made directly to the physical
+//   EEPROM's cache, see test/stubs.c.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "hal.h"
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	void* object;
+} eeprom_t;
+
+typedef struct
+{
+	eeprom_t base;
+} virtualEeprom_t;
+
+// Functions ------------------------------------------------------------------------------------------------------------------
+
+bool eepromWrite (eeprom_t* eeprom, uint16_t addr, const void* data, uint16_t dataCount);
+
+#endif // EEPROM_H
\ No newline at end of file
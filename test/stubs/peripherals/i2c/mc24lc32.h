@@ -0,0 +1,29 @@
+#ifndef MC24LC32_H
+#define MC24LC32_H
+
+// EEPROM Stub ----------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's MC24LC32 driver. Only the cache is modelled, the memory map is read
+//   from it directly.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "peripherals/eeprom.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define MC24LC32_SIZE 0x1000
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef struct
+{
+	eeprom_t base;
+	uint8_t cache [MC24LC32_SIZE];
+} mc24lc32_t;
+
+#endif // MC24LC32_H
\ No newline at end of file
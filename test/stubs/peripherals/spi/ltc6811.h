@@ -0,0 +1,39 @@
+#ifndef LTC6811_H
+#define LTC6811_H
+
+// LTC6811 Stub ---------------------------------------------------------------------------------------------------------------
+//
+// Author: agent
+// Date Created: 2026.10.17
+//
+// Description: Host stand-in for the common library's LTC6811 driver, modelling only the fields of each device.
+
+// Includes -------------------------------------------------------------------------------------------------------------------
+
+// Includes
+#include "hal.h"
+
+// Constants ------------------------------------------------------------------------------------------------------------------
+
+#define LTC6811_CELL_COUNT	12
+#define LTC6811_GPIO_COUNT	5
+
+// Datatypes ------------------------------------------------------------------------------------------------------------------
+
+typedef enum
+{
+	LTC6811_STATE_FAILED		= 0,
+	LTC6811_STATE_PEC_ERROR		= 1,
+	LTC6811_STATE_SELF_TEST_FAULT	= 2,
+	LTC6811_STATE_READY			= 3
+} ltc6811State_t;
+
+typedef struct
+{
+	float cellVoltages [LTC6811_CELL_COUNT];
+	float cellVoltageSum;
+	bool cellsDischarging [LTC6811_CELL_COUNT];
+	float dieTemperature;
+} ltc6811_t;
+
+#endif // LTC6811_H
\ No newline at end of file